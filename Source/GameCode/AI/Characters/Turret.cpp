@@ -4,6 +4,12 @@
 #include "Components/Combat/ExplosionComponent.h"
 #include "Components/Combat/TurretBarrelComponent.h"
 #include "Perception/AISense_Damage.h"
+#include "Subsystems/GCDamageQueueSubsystem.h"
+#include "Subsystems/GCRadialDamageSubsystem.h"
+#include "GameCode.h"
+
+// a long hitch shouldn't unload a whole belt in one frame
+static constexpr int32 TurretMaxShotsPerFrame = 8;
 
 ATurret::ATurret()
 {
@@ -27,6 +33,7 @@ ATurret::ATurret()
 
 void ATurret::Tick(float DeltaTime)
 {
+	GC_TRACE_SCOPE(ATurret_Tick);
 	Super::Tick(DeltaTime);
 
 	switch (CurrentMode)
@@ -35,7 +42,15 @@ void ATurret::Tick(float DeltaTime)
 			Search(DeltaTime);
 		break;
 		case ETurretMode::Attack:
+		{
+			const FQuat PreviousBarrelRotation = TurretBarrelComponent->GetComponentQuat();
 			Track(DeltaTime);
+			TArray<float, TInlineAllocator<8>> ShotAges;
+			if (FireScheduler.Advance(DeltaTime, ShotAges, TurretMaxShotsPerFrame) > 0)
+			{
+				Shoot(ShotAges, PreviousBarrelRotation, DeltaTime);
+			}
+		}
 		break;
 		default:
 			break;
@@ -49,6 +64,11 @@ void ATurret::SetCurrentTarget(AActor* NewTarget)
 		return;
 	}
 	
+	if (Target != NewTarget)
+	{
+		AimLead = FVector::ZeroVector;
+	}
+	
 	Target = NewTarget;
 	KillableTarget = Cast<IKillable>(NewTarget);
 	SetMode(Target.IsValid() ? ETurretMode::Attack : ETurretMode::Search);
@@ -80,7 +100,15 @@ void ATurret::BeginPlay()
 {
 	Super::BeginPlay();
 	Health = MaxHealth;
-	OnTakeAnyDamage.AddDynamic(this, &ATurret::OnDamageTaken);
+	GetWorld()->GetSubsystem<UGCDamageQueueSubsystem>()->RegisterReceiver(this);
+	GetWorld()->GetSubsystem<UGCRadialDamageSubsystem>()->RegisterDamageable(this);
+}
+
+void ATurret::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetSubsystem<UGCDamageQueueSubsystem>()->UnregisterReceiver(this);
+	GetWorld()->GetSubsystem<UGCRadialDamageSubsystem>()->UnregisterDamageable(this);
+	Super::EndPlay(EndPlayReason);
 }
 
 void ATurret::Search(float DeltaTime)
@@ -96,12 +124,13 @@ void ATurret::Search(float DeltaTime)
 
 void ATurret::Track(float DeltaTime)
 {
-	FVector BaseLookAtDirection = (Target->GetActorLocation() - TurretBaseComponent->GetComponentLocation()).GetSafeNormal2D();
+	const FVector AimLocation = Target->GetActorLocation() + AimLead;
+	FVector BaseLookAtDirection = (AimLocation - TurretBaseComponent->GetComponentLocation()).GetSafeNormal2D();
 	FQuat LookAtQuat = BaseLookAtDirection.ToOrientationQuat();
 	FQuat TargetQuat = FMath::QInterpTo(TurretBaseComponent->GetComponentQuat(), LookAtQuat, DeltaTime, LookAtInterpSpeed);
 	TurretBaseComponent->SetWorldRotation(TargetQuat);
 
-	FVector GunLookAtDirection = (Target->GetActorLocation() - TurretBarrelComponent->GetComponentLocation()).GetSafeNormal();
+	FVector GunLookAtDirection = (AimLocation - TurretBarrelComponent->GetComponentLocation()).GetSafeNormal();
 	float GunLookAtPitch = GunLookAtDirection.ToOrientationRotator().Pitch;
 	FRotator CurrentGunRotation = TurretGunComponent->GetRelativeRotation();
 	CurrentGunRotation.Pitch = FMath::FInterpTo(CurrentGunRotation.Pitch, GunLookAtPitch, DeltaTime, LookAtInterpSpeed);
@@ -116,20 +145,24 @@ void ATurret::SetMode(ETurretMode NewMode)
 	}
 	
 	CurrentMode = NewMode;
-	switch (CurrentMode)
+	if (CurrentMode == ETurretMode::Attack)
 	{
-		case ETurretMode::Search:
-			GetWorld()->GetTimerManager().ClearTimer(ShootDelayTimer);
-		break;
-		case ETurretMode::Attack:
-			GetWorld()->GetTimerManager().SetTimer(ShootDelayTimer, this, &ATurret::Shoot, GetFireInterval(), true, FireDelayTime);
-		break;
-	}	
+		FireScheduler.Start(GetFireInterval(), FireDelayTime);
+	}
 }
 
-void ATurret::Shoot()
+void ATurret::Shoot(TArrayView<const float> ShotAges, const FQuat& PreviousBarrelRotation, float DeltaTime)
 {
-	TurretBarrelComponent->Shoot(TurretBarrelComponent->GetComponentLocation(), TurretBarrelComponent->GetComponentRotation().Vector(), Controller);
+	GC_TRACE_SCOPE(ATurret_Shoot);
+	const FVector MuzzleLocation = TurretBarrelComponent->GetComponentLocation();
+	const FQuat CurrentBarrelRotation = TurretBarrelComponent->GetComponentQuat();
+	for (const float ShotAge : ShotAges)
+	{
+		const float Alpha = DeltaTime > 0.f ? FMath::Clamp(1.f - ShotAge / DeltaTime, 0.f, 1.f) : 1.f;
+		const FVector Direction = FQuat::Slerp(PreviousBarrelRotation, CurrentBarrelRotation, Alpha).GetForwardVector();
+		TurretBarrelComponent->Shoot(MuzzleLocation, Direction, Controller, ShotAge);
+	}
+	
 	TurretBarrelComponent->FinalizeShot();
 	if (KillableTarget && !KillableTarget->IsAlive())
 	{
@@ -137,6 +170,11 @@ void ATurret::Shoot()
 	}
 }
 
+void ATurret::ApplyQueuedDamage(const FQueuedDamage& QueuedDamage)
+{
+	OnDamageTaken(this, QueuedDamage.Damage, QueuedDamage.DamageType.Get(), QueuedDamage.InstigatedBy.Get(), QueuedDamage.DamageCauser.Get());
+}
+
 void ATurret::OnDamageTaken(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
 	AController* InstigatedBy, AActor* DamageCauser)
 {
@@ -146,14 +184,15 @@ void ATurret::OnDamageTaken(AActor* DamagedActor, float Damage, const UDamageTyp
 	}
 	
 	Health = FMath::Clamp(Health - Damage, 0.f, MaxHealth);
-	UAISense_Damage::ReportDamageEvent(GetWorld(), this, DamageCauser, Damage, DamageCauser->GetActorLocation(), GetActorLocation());
+	// queued damage outlives projectiles sometimes
+	const FVector DamageLocation = IsValid(DamageCauser) ? DamageCauser->GetActorLocation() : GetActorLocation();
+	UAISense_Damage::ReportDamageEvent(GetWorld(), this, DamageCauser, Damage, DamageLocation, GetActorLocation());
 	if (Health <= 0)
 	{
 		SetActorTickEnabled(false);
-		GetWorld()->GetTimerManager().ClearTimer(ShootDelayTimer);
 		OnExploded();
 		ExplosionComponent->Explode(Controller);
-		OnTakeAnyDamage.RemoveDynamic(this, &ATurret::OnDamageTaken);
+		GetWorld()->GetSubsystem<UGCDamageQueueSubsystem>()->UnregisterReceiver(this);
 		if (DeathEvent.IsBound()) DeathEvent.Broadcast();
 	}
 }
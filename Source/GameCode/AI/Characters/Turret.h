@@ -4,7 +4,9 @@
 #include "Data/AITypesGC.h"
 #include "GameFramework/Pawn.h"
 #include "Interfaces/Killable.h"
+#include "Interfaces/QueuedDamageReceiver.h"
 #include "UObject/WeakInterfacePtr.h"
+#include "Utils/GCFireScheduler.h"
 #include "Turret.generated.h"
 
 DECLARE_MULTICAST_DELEGATE(FDeathEvent)
@@ -18,7 +20,7 @@ enum class ETurretMode : uint8
 };
 
 UCLASS()
-class GAMECODE_API ATurret : public APawn
+class GAMECODE_API ATurret : public APawn, public IQueuedDamageReceiver
 {
 	GENERATED_BODY()
 
@@ -28,6 +30,10 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 	void SetCurrentTarget(AActor* NewTarget);
+	AActor* GetCurrentTarget() const { return Target.Get(); }
+	class UTurretBarrelComponent* GetBarrel() const { return TurretBarrelComponent; }
+	// Offset from the target location to aim at, see UGCTurretTargetingSubsystem
+	void SetAimLead(const FVector& NewAimLead) { AimLead = NewAimLead; }
 
 	virtual FVector GetPawnViewLocation() const override;
 	virtual FRotator GetViewRotation() const override;
@@ -35,6 +41,8 @@ public:
 	virtual void PossessedBy(AController* NewController) override;
 	ETeam GetTeam() const { return Team; }
 
+	virtual void ApplyQueuedDamage(const FQueuedDamage& QueuedDamage) override;
+
 	mutable FDeathEvent DeathEvent;
 	
 protected:
@@ -86,6 +94,7 @@ protected:
 	float MaxHealth = 250.f;
 	
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnExploded();
@@ -99,14 +108,15 @@ private:
 	void SetMode(ETurretMode NewMode);
 	float GetFireInterval() const { return 60.f / FireRate; }
 
-	void Shoot();
+	// PreviousBarrelRotation - barrel rotation at the start of the frame, older shots are aimed closer to it
+	void Shoot(TArrayView<const float> ShotAges, const FQuat& PreviousBarrelRotation, float DeltaTime);
 	
 	TWeakObjectPtr<AActor> Target = nullptr;
 	IKillable* KillableTarget = nullptr;
+	FVector AimLead = FVector::ZeroVector;
 	
-	FTimerHandle ShootDelayTimer;
+	FFireScheduler FireScheduler;
 	
-	UFUNCTION()
 	void OnDamageTaken(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
 		AController* InstigatedBy, AActor* DamageCauser);
 
@@ -3,6 +3,7 @@
 #include "AI/Characters/GCAICharacter.h"
 #include "AI/Components/AIPatrolComponent.h"
 #include "Perception/AISense_Sight.h"
+#include "GameCode.h"
 
 void AAICharacterController::BeginPlay()
 {
@@ -57,6 +58,7 @@ void AAICharacterController::OnMoveCompleted(FAIRequestID RequestID, const FPath
 
 void AAICharacterController::TryMoveToNextTarget()
 {
+	GC_TRACE_SCOPE(AAICharacterController_TryMoveToNextTarget);
 	AActor* ActorToFollow = GetClosestSensedActor(UAISense_Sight::StaticClass());
 	if (IsValid(ActorToFollow) && !IsTargetReached(ActorToFollow->GetActorLocation(), ActorTargetReachRadius))
 	{
@@ -5,6 +5,8 @@
 #include "Perception/AIPerceptionComponent.h"
 #include "Perception/AISense_Damage.h"
 #include "Perception/AISense_Sight.h"
+#include "Subsystems/GCTurretTargetingSubsystem.h"
+#include "GameCode.h"
 
 AAITurretController::AAITurretController()
 {
@@ -60,6 +62,12 @@ void AAITurretController::OnTargetPerceptionUpdated(AActor* Actor, FAIStimulus S
 
 void AAITurretController::Think()
 {
+	GC_TRACE_SCOPE(AAITurretController_Think);
+	if (ControlledTurret.IsValid())
+	{
+		GetWorld()->GetSubsystem<UGCTurretTargetingSubsystem>()->RequestLead(ControlledTurret.Get());
+	}
+	
 	if (IsValid(MostDangerousActorInfo.Key))
 	{
 		return;
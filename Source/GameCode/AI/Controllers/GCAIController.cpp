@@ -2,14 +2,29 @@
 
 #include "Characters/GCBaseCharacter.h"
 #include "Perception/AIPerceptionComponent.h"
+#include "GameCode.h"
 
 AGCAIController::AGCAIController()
 {
 	PerceptionComponent = CreateDefaultSubobject<UAIPerceptionComponent>(TEXT("Perception"));
 }
 
+void AGCAIController::OnPossess(APawn* InPawn)
+{
+	GC_LLM_SCOPE(AI);
+	Super::OnPossess(InPawn);
+	TRACE_COUNTER_INCREMENT(GCActiveAI);
+}
+
+void AGCAIController::OnUnPossess()
+{
+	Super::OnUnPossess();
+	TRACE_COUNTER_DECREMENT(GCActiveAI);
+}
+
 AActor* AGCAIController::GetClosestSensedActor(TSubclassOf<UAISense> SenseType) const
 {
+	GC_TRACE_SCOPE(AGCAIController_GetClosestSensedActor);
 	if (!IsValid(GetPawn()))
 	{
 		return nullptr;
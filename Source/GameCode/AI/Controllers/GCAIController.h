@@ -14,5 +14,8 @@ public:
 	AGCAIController();
 
 protected:
+	virtual void OnPossess(APawn* InPawn) override;
+	virtual void OnUnPossess() override;
+	
 	AActor* GetClosestSensedActor(TSubclassOf<UAISense> SenseType) const;
 };
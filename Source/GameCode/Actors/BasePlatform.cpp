@@ -4,6 +4,7 @@
 #include "BasePlatform.h"
 
 #include "PlatformInvocator.h"
+#include "GameCode.h"
 
 ABasePlatform::ABasePlatform()
 {
@@ -72,6 +73,7 @@ void ABasePlatform::ReverseStop()
 // Called every frame
 void ABasePlatform::Tick(float DeltaTime)
 {
+	GC_TRACE_SCOPE(ABasePlatform_Tick);
 	Super::Tick(DeltaTime);
 
 	if (PlatformTimeline.IsPlaying())
@@ -1,33 +1,42 @@
 #include "Actors/Equipment/Weapons/MeleeWeaponItem.h"
 #include "Components/Combat/MeleeHitRegistratorComponent.h"
+#include "GameCode.h"
+#include "GameFramework/Pawn.h"
+#include "Utils/DebugUtils.h"
 
 AMeleeWeaponItem::AMeleeWeaponItem()
 {
-	
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 }
 
 void AMeleeWeaponItem::BeginPlay()
 {
 	Super::BeginPlay();
 	GetComponents<UMeleeHitRegistratorComponent>(HitRegistrators);
-	for (const auto HitRegistrator : HitRegistrators)
-	{
-		HitRegistrator->MeleeHitRegisteredEvent.BindUObject(this, &AMeleeWeaponItem::OnMeleeHitRegistered);
-	}
+}
+
+void AMeleeWeaponItem::Tick(float DeltaTime)
+{
+	GC_TRACE_SCOPE(AMeleeWeaponItem_Tick);
+	Super::Tick(DeltaTime);
+	ProcessHitRegistration(DeltaTime);
 }
 
 void AMeleeWeaponItem::SetIsHitRegistrationEnabled(bool bEnabled)
 {
-	HitActors.Empty();
+	HitActors.Reset();
 	for (auto HitRegistrator : HitRegistrators)
 	{
 		HitRegistrator->SetIsEnabled(bEnabled);
 	}
+
+	SetActorTickEnabled(bEnabled && HitRegistrators.Num() > 0);
 }
 
 void AMeleeWeaponItem::StartAttack(EMeleeAttackType AttackType, AController* Controller)
 {
-	HitActors.Empty();
+	HitActors.Reset();
 	ActiveAttack = Attacks.Find(AttackType);
 	AttackerController = Controller;
 }
@@ -37,12 +46,67 @@ void AMeleeWeaponItem::StopAttack()
 	SetIsHitRegistrationEnabled(false);	// idk
 }
 
-void AMeleeWeaponItem::OnMeleeHitRegistered(const FHitResult& HitResult, const FVector& Direction)
+void AMeleeWeaponItem::ProcessHitRegistration(float DeltaTime)
+{
+	const bool bDrawDebugEnabled = GCDebug::IsCategoryEnabled(EGCDebugCategory::MeleeWeapons);
+	const GCTraceUtils::FTraceParams TraceParams(bDrawDebugEnabled);
+	const FCollisionQueryParams& CollisionParams = QueryParams.Get(this);
+	// everything along the path is reported as an overlap so one sweep registers every actor the swing passes through.
+	// Blocking geometry is handled in OnMeleeHitRegistered
+	static const FCollisionResponseParams ResponseParams(ECR_Overlap);
+	const UWorld* World = GetWorld();
+	TArray<FVector, TInlineAllocator<8>> SweepPoints;
+	for (UMeleeHitRegistratorComponent* HitRegistrator : HitRegistrators)
+	{
+		if (!HitRegistrator->IsEnabled())
+		{
+			continue;
+		}
+
+		HitRegistrator->GetSweepPoints(DeltaTime, SweepPoints);
+		HitRegistrator->CachePreviousState();
+		const float Radius = HitRegistrator->GetScaledSphereRadius();
+		bool bBlocked = false;
+		for (int32 i = 1; i < SweepPoints.Num() && !bBlocked; ++i)
+		{
+			SweepHits.Reset();
+			if (!GCTraceUtils::SweepSphereMultiByChannel(World, SweepHits, SweepPoints[i - 1], SweepPoints[i], Radius,
+				ECC_MeleeHitRegistrator, CollisionParams, TraceParams, ResponseParams))
+			{
+				continue;
+			}
+
+			const FVector Direction = (SweepPoints[i] - SweepPoints[i - 1]).GetSafeNormal();
+			for (const FHitResult& Hit : SweepHits)
+			{
+				if (!OnMeleeHitRegistered(Hit, Direction))
+				{
+					bBlocked = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+bool AMeleeWeaponItem::OnMeleeHitRegistered(const FHitResult& HitResult, const FVector& Direction)
 {
+	GC_TRACE_SCOPE(AMeleeWeaponItem_OnMeleeHitRegistered);
 	AActor* HitActor = HitResult.GetActor();
-	if (!IsValid(HitActor) || HitActors.Contains(HitActor) || !ActiveAttack)
+	const UPrimitiveComponent* HitComponent = HitResult.GetComponent();
+	// only what actually blocks the channel counts as a hit, same as a single sweep
+	if (!IsValid(HitActor) || !IsValid(HitComponent) || HitComponent->GetCollisionResponseToChannel(ECC_MeleeHitRegistrator) != ECR_Block)
+	{
+		return true;
+	}
+
+	// walls and props stop the swing, pawns are cut through
+	const bool bBlocking = !HitActor->IsA<APawn>();
+	bool bAlreadyHit = false;
+	HitActors.Add(HitActor, &bAlreadyHit);
+	if (bAlreadyHit || !ActiveAttack)
 	{
-		return;
+		return !bBlocking;
 	}
 
 	FPointDamageEvent DamageEvent;
@@ -50,5 +114,5 @@ void AMeleeWeaponItem::OnMeleeHitRegistered(const FHitResult& HitResult, const F
 	DamageEvent.ShotDirection = Direction;
 	DamageEvent.DamageTypeClass = ActiveAttack->DamageTypeClass;
 	HitActor->TakeDamage(ActiveAttack->DamageAmount, DamageEvent, AttackerController, GetOwner());
-	HitActors.Add(HitActor);
+	return !bBlocking;
 }
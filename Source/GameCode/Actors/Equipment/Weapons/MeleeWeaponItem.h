@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Actors/Equipment/EquippableItem.h"
 #include "Data/MeleeAttackData.h"
+#include "Utils/GCTraceUtils.h"
 #include "MeleeWeaponItem.generated.h"
 
 UCLASS(Blueprintable)
@@ -12,6 +13,9 @@ class GAMECODE_API AMeleeWeaponItem : public AEquippableItem
 
 public:
 	AMeleeWeaponItem();
+
+	// Only ticks while hit registration is on
+	virtual void Tick(float DeltaTime) override;
 	
 	const FMeleeAttackData* GetMeleeAttackData(EMeleeAttackType AttackType) { return Attacks.Find(AttackType); }
 
@@ -27,11 +31,18 @@ protected:
 	TMap<EMeleeAttackType, FMeleeAttackData> Attacks;
 
 private:
-
-	void OnMeleeHitRegistered(const FHitResult& HitResult, const FVector& Direction);
+	void ProcessHitRegistration(float DeltaTime);
+	// Returns false if the hit blocks the rest of the swing
+	bool OnMeleeHitRegistered(const FHitResult& HitResult, const FVector& Direction);
 	
 	TArray<class UMeleeHitRegistratorComponent*> HitRegistrators;
-	TSet<AActor*> HitActors;
+	// actors already damaged by the current attack
+	TSet<const AActor*, DefaultKeyFuncs<const AActor*>, TInlineSetAllocator<8>> HitActors;
+
+	// ignores weapon -> character -> controller chain, rebuilt when the weapon changes hands
+	GCTraceUtils::FOwnerChainQueryParams QueryParams = GCTraceUtils::FOwnerChainQueryParams(FName("MeleeHitRegistration"));
+	// scratch
+	TArray<FHitResult> SweepHits;
 
 	const FMeleeAttackData* ActiveAttack = nullptr;
 	AController* AttackerController;
@@ -7,8 +7,23 @@
 #include "Camera/CameraComponent.h"
 #include "Characters/GCBaseCharacter.h"
 #include "Components/Combat/WeaponBarrelComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PawnMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
+#include "Subsystems/GCLagCompensationSubsystem.h"
+
+static float ShotViewOriginTolerance = 100.f;
+static FAutoConsoleVariableRef CVarShotViewOriginTolerance(
+	TEXT("gc.Weapons.ShotViewOriginTolerance"),
+	ShotViewOriginTolerance,
+	TEXT("Server rejects client shots whose view origin is further than this from the shooter's camera reach, after movement since the shot"));
+
+static float ShotBudgetSeconds = 0.25f;
+static FAutoConsoleVariableRef CVarShotBudgetSeconds(
+	TEXT("gc.Weapons.ShotBudgetSeconds"),
+	ShotBudgetSeconds,
+	TEXT("How many seconds of fire rate a client can bank on the server, so shots bunched up by network jitter aren't rejected"));
 
 ARangeWeaponItem::ARangeWeaponItem()
 {
@@ -22,6 +37,46 @@ ARangeWeaponItem::ARangeWeaponItem()
 	ScopeCameraComponent->SetupAttachment(WeaponMeshComponent);
 	
 	ReticleType = EReticleType::Crosshair;
+
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void ARangeWeaponItem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (!bFiring || ActiveWeaponBarrel->GetFireModeSettings().FireMode != EWeaponFireMode::FullAuto)
+	{
+		// single shot keeps the weapon busy for one interval, same as stopping full auto fire
+		FireScheduler.Cooldown(DeltaTime);
+		if (FireScheduler.IsReady())
+		{
+			StopFiring();
+			SetActorTickEnabled(false);
+		}
+
+		return;
+	}
+
+	// all shots due this frame go out together, older ones are moved ahead by the time they were due
+	GC_TRACE_SCOPE(ARangeWeaponItem_FireBatch);
+	TArray<float, TInlineAllocator<8>> ShotAges;
+	FireScheduler.Advance(DeltaTime, ShotAges, FMath::Max(GetAmmo(), 1));
+	int32 ShotsCount = 0;
+	for (const float ShotAge : ShotAges)
+	{
+		if (!Shoot(ShotAge))
+		{
+			break;
+		}
+
+		ShotsCount++;
+	}
+
+	if (ShotsCount > 0)
+	{
+		FinalizeShots(ShotsCount);
+	}
 }
 
 EReticleType ARangeWeaponItem::GetReticleType() const
@@ -44,6 +99,7 @@ void ARangeWeaponItem::BeginPlay()
 	
 	ActiveBarrelIndex = 0;
 	ActiveWeaponBarrel = Barrels[ActiveBarrelIndex];
+	SpreadStream.Initialize(SpreadSeed != 0 ? SpreadSeed : FMath::Rand());
 	AmmoChangedEvent.ExecuteIfBound(ActiveWeaponBarrel->GetAmmo());
 }
 
@@ -51,15 +107,23 @@ void ARangeWeaponItem::BeginPlay()
 
 bool ARangeWeaponItem::TryStartFiring(AController* ShooterController)
 {
-	// why not bFiring?
-	if (GetWorld()->GetTimerManager().IsTimerActive(ShootTimer))
+	// the last shot is still cooling down
+	if (!FireScheduler.IsReady())
 	{
 		return false;
 	}
 	
 	CachedShooterController = ShooterController;
 	bFiring = true;
-	return Shoot();
+	if (!Shoot())
+	{
+		return false;
+	}
+
+	FinalizeShots(1);
+	FireScheduler.Start(GetShootTimerInterval(), GetShootTimerInterval());
+	SetActorTickEnabled(true);
+	return true;
 }
 
 void ARangeWeaponItem::StopFiring()
@@ -67,8 +131,9 @@ void ARangeWeaponItem::StopFiring()
 	bFiring = false;
 }
 
-bool ARangeWeaponItem::Shoot()
+bool ARangeWeaponItem::Shoot(float ShotAge)
 {
+	GC_TRACE_SCOPE(ARangeWeaponItem_Shoot);
 	int32 Ammo = GetAmmo();
 	if (Ammo <= 0)
 	{
@@ -81,69 +146,183 @@ bool ARangeWeaponItem::Shoot()
 		return false;
 	}
 
+	// the local shot uses the quantized view too, so the server traces exactly the same pellets
+	const FShotPacket Packet = MakeShotPacket();
+	FireShot(Packet, ShotAge);
+	SetAmmo(Ammo - 1);
+	if (!HasAuthority())
+	{
+		PendingShotPackets.Add(Packet);
+	}
+	
+	return true;
+}
+
+FShotPacket ARangeWeaponItem::MakeShotPacket() const
+{
 	FVector ViewLocation;
 	FRotator ViewRotation;
 	CachedShooterController->GetPlayerViewPoint(ViewLocation, ViewRotation);
-	FVector ViewDirection = ViewRotation.Vector();
-	const FFireModeSettings& FireModeSettings = ActiveWeaponBarrel->GetFireModeSettings();
-	for (auto i = 0; i < FireModeSettings.BulletsPerShot; i++)
+
+	FShotPacket Packet;
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	Packet.ShooterTime = IsValid(GameState) ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	// same rounding as FVector_NetQuantize10 serialization
+	Packet.ViewOrigin = FVector(FMath::RoundToFloat(ViewLocation.X * 10.f) / 10.f, FMath::RoundToFloat(ViewLocation.Y * 10.f) / 10.f,
+		FMath::RoundToFloat(ViewLocation.Z * 10.f) / 10.f);
+	Packet.ViewPitch = FRotator::CompressAxisToShort(ViewRotation.Pitch);
+	Packet.ViewYaw = FRotator::CompressAxisToShort(ViewRotation.Yaw);
+	Packet.SpreadSeed = SpreadStream.GetCurrentSeed();
+	Packet.FireModeIndex = ActiveBarrelIndex;
+	Packet.bAiming = bAiming;
+	return Packet;
+}
+
+void ARangeWeaponItem::FireShot(const FShotPacket& Packet, float ShotAge, float ShotTime)
+{
+	UWeaponBarrelComponent* Barrel = Barrels[Packet.FireModeIndex];
+	TArray<FVector, TInlineAllocator<16>> ShotDirections;
+	SpreadStream.GenerateDirections(Packet.GetViewRotation(), GetBulletSpreadAngleRad(Barrel, Packet.bAiming),
+		Barrel->GetFireModeSettings().BulletsPerShot, ShotDirections);
+	Barrel->ShootPellets(Packet.ViewOrigin, ShotDirections, CachedShooterController, ShotAge, ShotTime);
+}
+
+// Animations, muzzle flash and sound are played once per frame, however many shots went out. Client shots of the frame
+// go to the server in one rpc, the server tells the rest of clients to play the fx
+void ARangeWeaponItem::FinalizeShots(int32 ShotsCount)
+{
+	PlayShotFX(ActiveWeaponBarrel.Get());
+	AGCBaseCharacter* CharacterOwner = Cast<AGCBaseCharacter>(GetOwner());
+	if (!IsValid(CharacterOwner))
 	{
-		ActiveWeaponBarrel->Shoot(ViewLocation, ViewDirection + GetBulletSpreadOffset(ViewRotation), CachedShooterController);
+		return;
 	}
-
-	SetAmmo(Ammo - 1);
-	PlayAnimMontage(FireModeSettings.WeaponShootMontage);
-	ActiveWeaponBarrel->FinalizeShot();
-	if (ShootEvent.IsBound())
+	
+	if (PendingShotPackets.Num() > 0)
 	{
-		ShootEvent.Broadcast(FireModeSettings.CharacterShootMontage);
+		CharacterOwner->Server_Shoot(PendingShotPackets);
+		PendingShotPackets.Reset();
+	}
+	else if (HasAuthority() && GetNetMode() != NM_Standalone)
+	{
+		CharacterOwner->Multicast_ShotsFired(ActiveBarrelIndex, FMath::Min(ShotsCount, (int32)MAX_uint8));
 	}
-
-	GetWorld()->GetTimerManager().SetTimer(ShootTimer, this, &ARangeWeaponItem::ResetShot, GetShootTimerInterval(), false);
-	return true;
 }
 
-void ARangeWeaponItem::ResetShot()
+void ARangeWeaponItem::ReplayShots(TArrayView<const FShotPacket> Packets, AController* ShooterController)
 {
-	if (!bFiring)
+	GC_TRACE_SCOPE(ARangeWeaponItem_ReplayShots);
+	AGCBaseCharacter* CharacterOwner = Cast<AGCBaseCharacter>(GetOwner());
+	if (!IsValid(CharacterOwner))
 	{
 		return;
 	}
+	
+	const UGCLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UGCLagCompensationSubsystem>();
+	CachedShooterController = ShooterController;
+	int32 ShotsCount = 0;
+	bool bSpreadSeedMismatch = false;
+	for (const FShotPacket& Packet : Packets)
+	{
+		const float ShotTime = LagCompensation->ClampShotTime(Packet.ShooterTime);
+		if (!Barrels.IsValidIndex(Packet.FireModeIndex) || !IsViewOriginValid(*CharacterOwner, Packet.ViewOrigin, ShotTime))
+		{
+			continue;
+		}
+
+		UWeaponBarrelComponent* Barrel = Barrels[Packet.FireModeIndex];
+		if (Barrel->GetAmmo() <= 0 || !ConsumeShotBudget(Barrel))
+		{
+			continue;
+		}
+
+		// fire mode switches aren't sent, the client's one is taken from its shots so the server reloads the right barrel
+		if (Packet.FireModeIndex != ActiveBarrelIndex)
+		{
+			SetActiveBarrel(Packet.FireModeIndex);
+		}
+		
+		// the spread sequence is the server's, the client only reports where it is in it. Out of sync shots still fire,
+		// with the server's next pellets, and don't advance the stream, so the client continues from there after the sync
+		if (Packet.SpreadSeed == SpreadStream.GetCurrentSeed())
+		{
+			bSpreadSeedSyncSent = false;
+			FireShot(Packet, 0.f, ShotTime);
+		}
+		else
+		{
+			bSpreadSeedMismatch = true;
+			const FSpreadStream SyncedSpreadStream = SpreadStream;
+			FireShot(Packet, 0.f, ShotTime);
+			SpreadStream = SyncedSpreadStream;
+		}
+		
+		SetAmmo(Barrel->GetAmmo() - 1);
+		ShotsCount++;
+	}
 
-	switch (ActiveWeaponBarrel->GetFireModeSettings().FireMode)
+	// shots fired before the client got the sync mismatch too, one sync until the client is back in the sequence
+	if (bSpreadSeedMismatch && !bSpreadSeedSyncSent)
 	{
-		case EWeaponFireMode::Single:
-			StopFiring();
-			break;
-		case EWeaponFireMode::FullAuto:
-			Shoot();
-			break;
-		default:
-			StopFiring();
-			break;
+		CharacterOwner->Client_SyncSpreadSeed(SpreadStream.GetCurrentSeed());
+		bSpreadSeedSyncSent = true;
+	}
+
+	if (ShotsCount > 0)
+	{
+		CharacterOwner->Multicast_ShotsFired(ActiveBarrelIndex, FMath::Min(ShotsCount, (int32)MAX_uint8));
 	}
 }
 
-FVector ARangeWeaponItem::GetBulletSpreadOffset(const FRotator& ShotOrientation) const
+bool ARangeWeaponItem::IsViewOriginValid(const AGCBaseCharacter& Shooter, const FVector& ViewOrigin, float ShotTime) const
 {
-	float PitchAngle = FMath::RandRange(0.f, GetBulletSpreadAngleRad());
-	if (FMath::IsNearlyZero(PitchAngle, KINDA_SMALL_NUMBER))
+	// the shooter could have moved since the shot, at most at its max speed
+	const UPawnMovementComponent* MovementComponent = Shooter.GetMovementComponent();
+	const float MaxMoveDistance = IsValid(MovementComponent) ? MovementComponent->GetMaxSpeed() * (GetWorld()->GetTimeSeconds() - ShotTime) : 0.f;
+	const float MaxDistance = Shooter.GetMaxCameraDistance() + MaxMoveDistance + ShotViewOriginTolerance;
+	return FVector::DistSquared(ViewOrigin, Shooter.GetPawnViewLocation()) <= FMath::Square(MaxDistance);
+}
+
+// Token bucket refilled at the fire rate of the barrel, up to gc.Weapons.ShotBudgetSeconds worth of shots
+bool ARangeWeaponItem::ConsumeShotBudget(const UWeaponBarrelComponent* Barrel)
+{
+	const float ShotsPerSecond = Barrel->GetFireModeSettings().FireRate / 60.f;
+	const float MaxShotBudget = 1.f + ShotsPerSecond * ShotBudgetSeconds;
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	ShotBudget = FMath::Min(ShotBudget + (CurrentTime - LastShotBudgetTime) * ShotsPerSecond, MaxShotBudget);
+	LastShotBudgetTime = CurrentTime;
+	if (ShotBudget < 1.f)
 	{
-		return FVector::ZeroVector;
+		return false;
 	}
-	
-	float SpreadSize = FMath::Tan(PitchAngle);
-	float RotationAngle = FMath::RandRange(0.f, 2 * PI);
-	float SpreadY = FMath::Cos(RotationAngle);
-	float SpreadZ = FMath::Sin(RotationAngle);
 
-	return (ShotOrientation.RotateVector(FVector::UpVector) * SpreadZ + ShotOrientation.RotateVector(FVector::RightVector) * SpreadY) * SpreadSize;
+	ShotBudget -= 1.f;
+	return true;
+}
+
+void ARangeWeaponItem::PlayRemoteShots(uint8 FireModeIndex, int32 ShotsCount)
+{
+	if (ShotsCount > 0 && Barrels.IsValidIndex(FireModeIndex))
+	{
+		PlayShotFX(Barrels[FireModeIndex]);
+	}
+}
+
+void ARangeWeaponItem::PlayShotFX(UWeaponBarrelComponent* Barrel)
+{
+	const FFireModeSettings& FireModeSettings = Barrel->GetFireModeSettings();
+	PlayAnimMontage(FireModeSettings.WeaponShootMontage);
+	Barrel->FinalizeShot();
+	if (ShootEvent.IsBound())
+	{
+		ShootEvent.Broadcast(FireModeSettings.CharacterShootMontage);
+	}
 }
 
-float ARangeWeaponItem::GetBulletSpreadAngleRad() const
+float ARangeWeaponItem::GetBulletSpreadAngleRad(const UWeaponBarrelComponent* Barrel, bool bAimingShot) const
 {
-	const FFireModeSettings& FireModeSettings = ActiveWeaponBarrel->GetFireModeSettings();
-	return FMath::DegreesToRadians(bAiming ? FireModeSettings.AimSpreadAngle : FireModeSettings.SpreadAngle); 
+	const FFireModeSettings& FireModeSettings = Barrel->GetFireModeSettings();
+	return FMath::DegreesToRadians(bAimingShot ? FireModeSettings.AimSpreadAngle : FireModeSettings.SpreadAngle); 
 }
 
 #pragma endregion SHOOT
@@ -196,10 +375,15 @@ void ARangeWeaponItem::StartTogglingFireMode()
 
 void ARangeWeaponItem::CompleteTogglingFireMode()
 {
-	ActiveBarrelIndex = (ActiveBarrelIndex + 1) % Barrels.Num();
+	SetActiveBarrel((ActiveBarrelIndex + 1) % Barrels.Num());
+	bChangingFireMode = false;
+}
+
+void ARangeWeaponItem::SetActiveBarrel(int32 BarrelIndex)
+{
+	ActiveBarrelIndex = BarrelIndex;
 	ActiveWeaponBarrel = Barrels[ActiveBarrelIndex];
 	AmmoChangedEvent.ExecuteIfBound(ActiveWeaponBarrel->GetAmmo());
-	bChangingFireMode = false;
 }
 
 const FFireModeSettings& ARangeWeaponItem::GetNextFireModeSettings() const
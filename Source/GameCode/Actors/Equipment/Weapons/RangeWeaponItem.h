@@ -5,6 +5,9 @@
 #include "Actors/Equipment/EquippableItem.h"
 #include "Components/Combat/WeaponBarrelComponent.h"
 #include "Data/EquipmentTypes.h"
+#include "Data/ShotPacket.h"
+#include "Utils/GCFireScheduler.h"
+#include "Utils/GCSpreadStream.h"
 #include "RangeWeaponItem.generated.h"
 
 class UAnimMontage;
@@ -21,6 +24,7 @@ class GAMECODE_API ARangeWeaponItem : public AEquippableItem
 	
 public:
 	ARangeWeaponItem();
+	virtual void Tick(float DeltaTime) override;
 
 	bool TryStartFiring(AController* ShooterController);
 	void StopFiring();
@@ -66,6 +70,18 @@ public:
 	const class UCameraComponent* GetScopeCameraComponent() const { return ScopeCameraComponent; }
 
 	bool CanAim() const { return ActiveWeaponBarrel->GetFireModeSettings().bCanAim; }
+
+	// Spread pattern is fully defined by the seed, so shots can be replayed or validated
+	int32 GetSpreadSeed() const { return SpreadStream.GetSeed(); }
+	void SetSpreadSeed(int32 Seed) { SpreadStream.Initialize(Seed); }
+	// Seed both the server and the owning client know, unless the weapon has its own SpreadSeed
+	void InitializeSpreadStream(int32 SharedSeed) { SpreadStream.Initialize(SpreadSeed != 0 ? SpreadSeed : SharedSeed); }
+
+	// Server side of client shots: pellets are rebuilt from the packets and traced at the shooter's time. Shots without ammo,
+	// over the fire rate or from too far from the shooter are dropped. The spread is always the server's sequence
+	void ReplayShots(TArrayView<const FShotPacket> Packets, AController* ShooterController);
+	// Muzzle flash, sound and animations of shots fired by another machine
+	void PlayRemoteShots(uint8 FireModeIndex, int32 ShotsCount);
 	
 protected:
 	
@@ -83,9 +99,15 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	FName MuzzleSocketName = "muzzle_socket";
 
+	// 0 - seeded from the owner's GetSpreadSeedBase() and the loadout slot, random without an owner
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 SpreadSeed = 0;
+
 private:
-	FTimerHandle ShootTimer;
+	// ticks the actor while firing or cooling down after the last shot
+	FFireScheduler FireScheduler;
 	FTimerHandle ChangeFireModeTimer;
+	FSpreadStream SpreadStream;
 	
 	bool bAiming = false;
 	bool bReloading = false;
@@ -96,10 +118,24 @@ private:
 
 	float PlayAnimMontage(UAnimMontage* AnimMontage, float DesiredDuration = -1);
 	float GetShootTimerInterval() const { return 60.f / ActiveWeaponBarrel->GetFireModeSettings().FireRate; };
-	bool Shoot();
-	void ResetShot();
-	FVector GetBulletSpreadOffset(const FRotator& ShotOrientation) const;
-	float GetBulletSpreadAngleRad () const;
+	bool Shoot(float ShotAge = 0.f);
+	FShotPacket MakeShotPacket() const;
+	void FireShot(const FShotPacket& Packet, float ShotAge, float ShotTime = -1.f);
+	void FinalizeShots(int32 ShotsCount);
+	void PlayShotFX(UWeaponBarrelComponent* Barrel);
+	float GetBulletSpreadAngleRad(const UWeaponBarrelComponent* Barrel, bool bAimingShot) const;
+
+	void SetActiveBarrel(int32 BarrelIndex);
+	bool IsViewOriginValid(const class AGCBaseCharacter& Shooter, const FVector& ViewOrigin, float ShotTime) const;
+	bool ConsumeShotBudget(const UWeaponBarrelComponent* Barrel);
+
+	// shots of this frame not sent to the server yet
+	TArray<FShotPacket> PendingShotPackets;
+
+	// server side fire rate check of client shots
+	float ShotBudget = 1.f;
+	float LastShotBudgetTime = 0.f;
+	bool bSpreadSeedSyncSent = false;
 
 	// Fire modes to cycle through
 	TArray<UWeaponBarrelComponent*> Barrels;
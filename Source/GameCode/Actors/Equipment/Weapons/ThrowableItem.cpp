@@ -5,34 +5,67 @@
 
 #include "DrawDebugHelpers.h"
 #include "Actors/Projectiles/GCProjectile.h"
+#include "GameCode.h"
+#include "Subsystems/GCProjectilePoolSubsystem.h"
+#include "Subsystems/GCTrajectoryPredictionSubsystem.h"
 
 void AThrowableItem::BeginPlay()
 {
 	Super::BeginPlay();
+	GC_LLM_SCOPE(Projectiles);
 	AttachedProjectile = GetWorld()->SpawnActor<AGCProjectile>(ProjectileClass, GetActorLocation(), FRotator::ZeroRotator);
 	AttachedProjectile->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
 	AttachedProjectile->SetOwner(GetOwner());
 }
 
 void AThrowableItem::Throw(AController* OwnerController)
+{
+	GC_TRACE_SCOPE(AThrowableItem_Throw);
+	CurrentProjectile->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	FVector LaunchVelocity;
+	GetThrowVelocity(OwnerController, CurrentProjectile->GetActorLocation(), LaunchVelocity);
+	const float LaunchSpeed = LaunchVelocity.Size();
+	CurrentProjectile->LaunchProjectile(LaunchVelocity / LaunchSpeed, LaunchSpeed, OwnerController);
+}
+
+const FPredictedArc& AThrowableItem::PredictThrow(AController* OwnerController) const
+{
+	GC_TRACE_SCOPE(AThrowableItem_PredictThrow);
+	const FVector LaunchLocation = GetLaunchLocation();
+	FVector LaunchVelocity;
+	GetThrowVelocity(OwnerController, LaunchLocation, LaunchVelocity);
+	const AGCProjectile* Projectile = CurrentProjectile.IsValid() ? CurrentProjectile.Get() : ProjectileClass.GetDefaultObject();
+	return GetWorld()->GetSubsystem<UGCTrajectoryPredictionSubsystem>()->PredictArc(this, LaunchLocation, LaunchVelocity,
+		GetWorld()->GetGravityZ() * Projectile->GetGravityScale(), Projectile->GetCollisionRadius());
+}
+
+void AThrowableItem::GetThrowVelocity(AController* OwnerController, const FVector& LaunchLocation, FVector& OutVelocity) const
 {
 	FVector ViewPoint;
 	FRotator ViewRotation;
 	OwnerController->GetPlayerViewPoint(ViewPoint, ViewRotation);
 	FVector LaunchDirection = ViewRotation.Vector();
 
-	CurrentProjectile->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 	FHitResult TraceResult;
 	const FVector TraceEnd = ViewPoint + LaunchDirection * ThrowSpeed;
 	bool bHit = GetWorld()->LineTraceSingleByChannel(TraceResult, ViewPoint, TraceEnd, ECC_Visibility);
 	LaunchDirection = bHit || TraceResult.bBlockingHit
-		? (TraceResult.ImpactPoint - CurrentProjectile->GetActorLocation()).GetSafeNormal()
-		: (TraceEnd - CurrentProjectile->GetActorLocation()).GetSafeNormal();
+		? (TraceResult.ImpactPoint - LaunchLocation).GetSafeNormal()
+		: (TraceEnd - LaunchLocation).GetSafeNormal();
 
 	FVector ViewUpVector = ViewRotation.RotateVector(FVector::UpVector);
 	LaunchDirection = LaunchDirection + FMath::Tan(FMath::DegreesToRadians(ThrowAngle)) * ViewUpVector;
-	
-	CurrentProjectile->LaunchProjectile(LaunchDirection.GetSafeNormal(), GetOwner()->GetVelocity().Size() + ThrowSpeed, OwnerController);
+	OutVelocity = LaunchDirection.GetSafeNormal() * (GetOwner()->GetVelocity().Size() + ThrowSpeed);
+}
+
+FVector AThrowableItem::GetLaunchLocation() const
+{
+	if (CurrentProjectile.IsValid())
+	{
+		return CurrentProjectile->GetActorLocation();
+	}
+
+	return AttachedProjectile.IsValid() ? AttachedProjectile->GetActorLocation() : GetActorLocation();
 }
 
 void AThrowableItem::Activate(AController* Controller)
@@ -50,8 +83,8 @@ AGCProjectile* AThrowableItem::GetCurrentProjectile()
 
 AGCProjectile* AThrowableItem::SpawnProjectile()
 {
-	CurrentProjectile = GetWorld()->SpawnActor<AGCProjectile>(ProjectileClass);
-	CurrentProjectile->SetOwner(GetOwner());
+	UGCProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UGCProjectilePoolSubsystem>();
+	CurrentProjectile = ProjectilePool->AcquireProjectile(ProjectileClass, FTransform::Identity, GetOwner());
 	return CurrentProjectile.Get();
 }
 
@@ -5,6 +5,8 @@
 #include "ThrowableItem.generated.h"
 
 class AGCProjectile;
+struct FPredictedArc;
+
 UCLASS(Blueprintable)
 class GAMECODE_API AThrowableItem : public AEquippableItem
 {
@@ -12,6 +14,8 @@ class GAMECODE_API AThrowableItem : public AEquippableItem
 
 public:
 	void Throw(AController* OwnerController);
+	// Where the projectile would fly if thrown now, for trajectory preview. See UGCTrajectoryPredictionSubsystem
+	const FPredictedArc& PredictThrow(AController* OwnerController) const;
 
 	const TSubclassOf<AGCProjectile>& GetProjectileClass() const { return ProjectileClass; }
 	UAnimMontage* GetThrowMontage() const { return ThrowMontage; }
@@ -45,6 +49,9 @@ protected:
 	virtual void BeginPlay() override;
 	
 private:
+	void GetThrowVelocity(AController* OwnerController, const FVector& LaunchLocation, FVector& OutVelocity) const;
+	FVector GetLaunchLocation() const;
+	
 	TWeakObjectPtr<AGCProjectile> AttachedProjectile;
 	TWeakObjectPtr<AGCProjectile> CurrentProjectile;
 };
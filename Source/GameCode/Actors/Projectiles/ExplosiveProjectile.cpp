@@ -2,6 +2,7 @@
 
 #include "Components/Combat/ExplosionComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameCode.h"
 
 AExplosiveProjectile::AExplosiveProjectile()
 {
@@ -12,7 +13,7 @@ AExplosiveProjectile::AExplosiveProjectile()
 void AExplosiveProjectile::Activate(AController* ThrowerController)
 {
 	Super::Activate(ThrowerController);
-	GetWorld()->GetTimerManager().SetTimer(DetonationTimer, this, &AExplosiveProjectile::Detonate, DetonationTime);
+	GetWorld()->GetTimerManager().SetTimer(DetonationTimer, this, &AExplosiveProjectile::OnDetonationTimerElapsed, DetonationTime);
 }
 
 void AExplosiveProjectile::OnProjectileLaunched()
@@ -23,14 +24,23 @@ void AExplosiveProjectile::OnProjectileLaunched()
 void AExplosiveProjectile::DestroyOnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor,
 	UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	GetWorld()->GetTimerManager().ClearTimer(DetonationTimer);
 	Detonate();
 	Super::DestroyOnHit(HitComponent, OtherActor, OtherComp, NormalImpulse, Hit);
 }
 
 void AExplosiveProjectile::Detonate()
 {
+	GC_TRACE_SCOPE(AExplosiveProjectile_Detonate);
 	if (CachedThrowerController.IsValid())
 	{
 		ExplosionComponent->Explode(CachedThrowerController.Get());
 	}
 }
+
+void AExplosiveProjectile::OnDetonationTimerElapsed()
+{
+	Detonate();
+	// back to the pool, same as exploding on hit
+	Release();
+}
@@ -34,4 +34,5 @@ private:
 	FTimerHandle DetonationTimer;
 
 	void Detonate();
+	void OnDetonationTimerElapsed();
 };
@@ -4,10 +4,14 @@
 #include "Actors/Projectiles/GCProjectile.h"
 
 #include "GameCode.h"
+#include "Subsystems/GCProjectilePoolSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "GameFramework/RotatingMovementComponent.h"
 
+// UProjectileMovementComponent::MaxSimulationIterations limit
+static constexpr int32 MaxSimulationIterationsCap = 25;
+
 AGCProjectile::AGCProjectile()
 {
 	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("Collision"));
@@ -26,6 +30,12 @@ AGCProjectile::AGCProjectile()
 void AGCProjectile::BeginPlay()
 {
 	Super::BeginPlay();
+	TRACE_COUNTER_INCREMENT(GCLiveProjectiles);
+	DefaultCollisionProfileName = CollisionComponent->GetCollisionProfileName();
+	bDefaultRotationFollowsVelocity = ProjectileMovementComponent->bRotationFollowsVelocity;
+	bDefaultForceSubStepping = ProjectileMovementComponent->bForceSubStepping;
+	DefaultMaxSimulationTimeStep = ProjectileMovementComponent->MaxSimulationTimeStep;
+	DefaultMaxSimulationIterations = ProjectileMovementComponent->MaxSimulationIterations;
 	if (bDestroyOnHit)
 	{
 		CollisionComponent->OnComponentHit.AddDynamic(this, &AGCProjectile::DestroyOnHit);
@@ -38,10 +48,22 @@ void AGCProjectile::BeginPlay()
 	}
 }
 
+void AGCProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (!bInPool)
+	{
+		TRACE_COUNTER_DECREMENT(GCLiveProjectiles);
+	}
+	
+	Super::EndPlay(EndPlayReason);
+}
+
 void AGCProjectile::LaunchProjectile(FVector Direction, float Speed, AController* ThrowerController)
 {
+	GC_TRACE_SCOPE(AGCProjectile_LaunchProjectile);
 	ProjectileMovementComponent->Velocity = Direction * Speed;
 	ProjectileMovementComponent->bSimulationEnabled = true;
+	UpdateSubstepping(Speed);
 	CollisionComponent->SetCollisionProfileName(ProfileProjectile);
 	AActor* ProjectileOwner = GetOwner();
 	while (IsValid(ProjectileOwner))
@@ -64,6 +86,44 @@ void AGCProjectile::LaunchProjectile(FVector Direction, float Speed, AController
 	}
 }
 
+// Step length is kept under MaxSubstepDistance radii whatever the frame rate, so a fast projectile moves in short sweeps
+// and doesn't cut arcs or corners through thin geometry. Projectiles slow enough for the default step pay nothing
+void AGCProjectile::UpdateSubstepping(float Speed)
+{
+	ResetSubstepping();
+	const float StepDistance = MaxSubstepDistance * GetCollisionRadius();
+	if (!bAdaptiveSubstepping || StepDistance <= KINDA_SMALL_NUMBER || Speed * DefaultMaxSimulationTimeStep <= StepDistance)
+	{
+		return;
+	}
+
+	// past the iterations cap the rest of the frame would be one long step, so steps get longer than StepDistance instead
+	// for projectiles too fast to cover the slowest frame within the cap
+	const float TimeStep = FMath::Max(StepDistance / Speed, 1.f / (MinSubsteppedFrameRate * MaxSimulationIterationsCap));
+	const int32 Iterations = FMath::CeilToInt(1.f / (MinSubsteppedFrameRate * TimeStep));
+	// substepping is skipped without gravity unless forced
+	ProjectileMovementComponent->bForceSubStepping = true;
+	ProjectileMovementComponent->MaxSimulationTimeStep = TimeStep;
+	ProjectileMovementComponent->MaxSimulationIterations = FMath::Clamp(Iterations, DefaultMaxSimulationIterations, MaxSimulationIterationsCap);
+}
+
+void AGCProjectile::ResetSubstepping()
+{
+	ProjectileMovementComponent->bForceSubStepping = bDefaultForceSubStepping;
+	ProjectileMovementComponent->MaxSimulationTimeStep = DefaultMaxSimulationTimeStep;
+	ProjectileMovementComponent->MaxSimulationIterations = DefaultMaxSimulationIterations;
+}
+
+float AGCProjectile::GetGravityScale() const
+{
+	return ProjectileMovementComponent->ProjectileGravityScale;
+}
+
+float AGCProjectile::GetCollisionRadius() const
+{
+	return CollisionComponent->GetScaledSphereRadius();
+}
+
 void AGCProjectile::Drop(AController* ThrowerController)
 {
 	CachedThrowerController = ThrowerController;
@@ -76,12 +136,62 @@ void AGCProjectile::Drop(AController* ThrowerController)
 void AGCProjectile::DestroyOnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor,
 	UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	GC_TRACE_SCOPE(AGCProjectile_DestroyOnHit);
 	ProjectileHitEvent.ExecuteIfBound(Hit, ProjectileMovementComponent->Velocity.GetSafeNormal());
-	Destroy();
+	Release();
 	// TODO expose UStaticMeshComponent and use SetLifeSpan instead of immediately destroying?
 	// SetLifeSpan(2.f); 	
 }
 
+#pragma region POOLING
+
+void AGCProjectile::Release()
+{
+	UGCProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UGCProjectilePoolSubsystem>();
+	if (bPooled && IsValid(ProjectilePool))
+	{
+		ProjectilePool->ReleaseProjectile(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AGCProjectile::OnAcquiredFromPool()
+{
+	bInPool = false;
+	TRACE_COUNTER_INCREMENT(GCLiveProjectiles);
+	CollisionComponent->SetCollisionProfileName(DefaultCollisionProfileName);
+	// projectile movement drops its updated component when it stops simulating
+	ProjectileMovementComponent->SetUpdatedComponent(CollisionComponent);
+	SetActorEnableCollision(true);
+	SetActorHiddenInGame(false);
+}
+
+void AGCProjectile::OnReleasedToPool()
+{
+	bInPool = true;
+	TRACE_COUNTER_DECREMENT(GCLiveProjectiles);
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	ProjectileHitEvent.Unbind();
+	CachedThrowerController.Reset();
+	
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetOwner(nullptr);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	CollisionComponent->ClearMoveIgnoreActors();
+	
+	ProjectileMovementComponent->StopMovementImmediately();
+	ProjectileMovementComponent->bSimulationEnabled = false;
+	ProjectileMovementComponent->bRotationFollowsVelocity = bDefaultRotationFollowsVelocity;
+	ResetSubstepping();
+	RotatingMovementComponent->RotationRate = FRotator::ZeroRotator;
+}
+
+#pragma endregion POOLING
+
 void AGCProjectile::OnProjectileStopped(const FHitResult& ImpactResult)
 {
 }
@@ -22,12 +22,26 @@ public:
 	mutable FProjectileHitEvent ProjectileHitEvent;
 
 	void LaunchProjectile(FVector Direction, float Speed, AController* ThrowerController);
+	float GetGravityScale() const;
+	float GetCollisionRadius() const;
 	
 	virtual void Activate(AController* ThrowerController) { CachedThrowerController = ThrowerController; }
 	void Drop(AController* ThrowerController);
 
+#pragma region POOLING
+
+	// Returns projectile to UGCProjectilePoolSubsystem if it came from there, otherwise destroys it
+	void Release();
+	
+	void SetPooled(bool bNewPooled) { bPooled = bNewPooled; }
+	virtual void OnAcquiredFromPool();
+	virtual void OnReleasedToPool();
+
+#pragma endregion POOLING
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	UFUNCTION()
 	virtual void DestroyOnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
@@ -50,12 +64,36 @@ protected:
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	FRotator BaseRotationRate;
+
+	// Projectiles launched fast enough to move more than MaxSubstepDistance per simulation step get shorter steps,
+	// slow ones keep the projectile movement settings
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Substepping")
+	bool bAdaptiveSubstepping = true;
+
+	// In collision radii
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Substepping", meta = (ClampMin = 0.1f, UIMin = 0.1f, EditCondition = "bAdaptiveSubstepping"))
+	float MaxSubstepDistance = 2.f;
+
+	// Frames longer than that are simulated with longer substeps instead of more of them
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Substepping", meta = (ClampMin = 1.f, UIMin = 1.f, EditCondition = "bAdaptiveSubstepping"))
+	float MinSubsteppedFrameRate = 15.f;
 	
 	virtual void OnProjectileLaunched() {}
 
 	TWeakObjectPtr<AController> CachedThrowerController;
 
 private:
+	bool bPooled = false;
+	bool bInPool = false;
+	FName DefaultCollisionProfileName = NAME_None;
+	bool bDefaultRotationFollowsVelocity = false;
+	bool bDefaultForceSubStepping = false;
+	float DefaultMaxSimulationTimeStep = 0.05f;
+	int32 DefaultMaxSimulationIterations = 4;
+
+	void UpdateSubstepping(float Speed);
+	void ResetSubstepping();
+	
 	UFUNCTION()
 	void OnProjectileStopped(const FHitResult& ImpactResult);
 
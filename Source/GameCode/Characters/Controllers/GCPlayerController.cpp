@@ -7,6 +7,7 @@
 #include "Components/NameplateComponent.h"
 #include "GameCode/Characters/GCBaseCharacter.h"
 #include "GameCode/Components/Movement/GCBaseCharacterMovementComponent.h"
+#include "GameCode.h"
 
 void AGCPlayerController::SetPawn(APawn* InPawn)
 {
@@ -29,6 +30,7 @@ void AGCPlayerController::SetPawn(APawn* InPawn)
 
 void AGCPlayerController::Tick(float DeltaSeconds)
 {
+	GC_TRACE_SCOPE(AGCPlayerController_Tick);
 	Super::Tick(DeltaSeconds);
 }
 
@@ -37,6 +39,7 @@ void AGCPlayerController::BeginPlay()
 	Super::BeginPlay();
 	if (IsValid(PlayerHUDWidgetClass))
 	{
+		GC_LLM_SCOPE(UI);
 		PlayerHUDWidget = CreateWidget<UPlayerHUDWidget>(GetWorld(), PlayerHUDWidgetClass);
 		PlayerHUDWidget->AddToViewport();
 	}
@@ -21,6 +21,10 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/PhysicsVolume.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Net/UnrealNetwork.h"
+#include "Subsystems/GCDamageQueueSubsystem.h"
+#include "Subsystems/GCLagCompensationSubsystem.h"
+#include "Subsystems/GCRadialDamageSubsystem.h"
 
 AGCBaseCharacter::AGCBaseCharacter(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer.SetDefaultSubobjectClass<UGCBaseCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
@@ -45,8 +49,25 @@ AGCBaseCharacter::AGCBaseCharacter(const FObjectInitializer& ObjectInitializer)
 	GetMesh()->bCastDynamicShadow = true;
 }
 
+void AGCBaseCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	// before begin play, so the loadout spawned on the server and the initial replication to clients already have it
+	if (HasAuthority())
+	{
+		SpreadSeedBase = FMath::Rand();
+	}
+}
+
+void AGCBaseCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME_CONDITION(AGCBaseCharacter, SpreadSeedBase, COND_InitialOnly);
+}
+
 void AGCBaseCharacter::BeginPlay()
 {
+	GC_LLM_SCOPE(Characters);
 	Super::BeginPlay();
 	GCMovementComponent->ClimbableTopReached.BindUObject(this, &AGCBaseCharacter::OnClimbableTopReached);
 	GCMovementComponent->StoppedClimbing.BindUObject(this, &AGCBaseCharacter::OnStoppedClimbing);
@@ -67,15 +88,39 @@ void AGCBaseCharacter::BeginPlay()
 	CharacterEquipmentComponent->AimingSpeedChangedEvent.BindUObject(GCMovementComponent, &UGCBaseCharacterMovementComponent::SetAimingSpeed);
 	CharacterEquipmentComponent->AimingSpeedResetEvent.BindUObject(GCMovementComponent, &UGCBaseCharacterMovementComponent::ResetAimingSpeed);
 	
-	OnTakeAnyDamage.AddDynamic(CharacterAttributesComponent, &UCharacterAttributesComponent::OnTakeAnyDamage);
-	OnTakeAnyDamage.AddDynamic(this, &AGCBaseCharacter::ReactToDamage);
+	// damage is summed up and applied once per frame in ApplyQueuedDamage
+	GetWorld()->GetSubsystem<UGCDamageQueueSubsystem>()->RegisterReceiver(this);
 
 	CharacterEquipmentComponent->CreateLoadout();
 	UpdateStrafingControls();
+
+	GetWorld()->GetSubsystem<UGCRadialDamageSubsystem>()->RegisterDamageable(this);
+	if (HasAuthority())
+	{
+		GetWorld()->GetSubsystem<UGCLagCompensationSubsystem>()->RegisterCharacter(this);
+	}
+}
+
+void AGCBaseCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (GetMesh()->IsSimulatingPhysics())
+	{
+		TRACE_COUNTER_DECREMENT(GCRagdolls);
+	}
+
+	GetWorld()->GetSubsystem<UGCDamageQueueSubsystem>()->UnregisterReceiver(this);
+	GetWorld()->GetSubsystem<UGCRadialDamageSubsystem>()->UnregisterDamageable(this);
+	if (HasAuthority())
+	{
+		GetWorld()->GetSubsystem<UGCLagCompensationSubsystem>()->UnregisterCharacter(this);
+	}
+	
+	Super::EndPlay(EndPlayReason);
 }
 
 void AGCBaseCharacter::Tick(float DeltaTime)
 {
+	GC_TRACE_SCOPE(AGCBaseCharacter_Tick);
 	Super::Tick(DeltaTime);
 	TryChangeSprintState();
 	const EPosture CurrentPosture = GCMovementComponent->GetCurrentPosture();
@@ -547,13 +592,14 @@ FZiplineParams AGCBaseCharacter::GetZipliningParameters(const AZipline* Zipline)
 
 void AGCBaseCharacter::Mantle(bool bForce)
 {
+	GC_TRACE_SCOPE(AGCBaseCharacter_Mantle);
 	if (!CanMantle() && !bForce)
 	{
 		return;
 	}
 	
 	FLedgeDescriptor LedgeDescriptor;
-	if (LedgeDetectionComponent->DetectLedge(LedgeDescriptor))
+	if (LedgeDetectionComponent->ConsumeLedge(LedgeDescriptor))
 	{
 		const auto ActorTransform = GetActorTransform();
 		const auto MantleSettings = GetMantlingSettings(LedgeDescriptor.MantlingHeight);
@@ -716,6 +762,40 @@ void AGCBaseCharacter::StopFiring()
 	CharacterEquipmentComponent->StopFiring();
 }
 
+bool AGCBaseCharacter::Server_Shoot_Validate(const TArray<FShotPacket>& Packets)
+{
+	return Packets.Num() > 0 && Packets.Num() <= MaxShotPacketsPerBatch;
+}
+
+void AGCBaseCharacter::Server_Shoot_Implementation(const TArray<FShotPacket>& Packets)
+{
+	if (CharacterAttributesComponent->IsAlive())
+	{
+		CharacterEquipmentComponent->ReplayShots(Packets);
+	}
+}
+
+void AGCBaseCharacter::Multicast_ShotsFired_Implementation(uint8 FireModeIndex, uint8 ShotsCount)
+{
+	if (!IsLocallyControlled() && GetNetMode() != NM_DedicatedServer)
+	{
+		CharacterEquipmentComponent->PlayRemoteShots(FireModeIndex, ShotsCount);
+	}
+}
+
+void AGCBaseCharacter::Client_SyncSpreadSeed_Implementation(int32 SpreadSeed)
+{
+	CharacterEquipmentComponent->SyncSpreadSeed(SpreadSeed);
+}
+
+void AGCBaseCharacter::Server_Reload_Implementation()
+{
+	if (CharacterAttributesComponent->IsAlive())
+	{
+		CharacterEquipmentComponent->TryReload();
+	}
+}
+
 void AGCBaseCharacter::StartAiming()
 {
 	CharacterEquipmentComponent->StartAiming();
@@ -834,8 +914,10 @@ void AGCBaseCharacter::OnMantleEnded()
 
 void AGCBaseCharacter::EnableRagdoll() const
 {
+	GC_LLM_SCOPE(Characters);
 	GetMesh()->SetCollisionProfileName(ProfileRagdoll);
 	GetMesh()->SetSimulatePhysics(true);
+	TRACE_COUNTER_INCREMENT(GCRagdolls);
 }
 
 void AGCBaseCharacter::UpdateStrafingControls()
@@ -889,6 +971,15 @@ float AGCBaseCharacter::PlayAnimMontageWithDuration(UAnimMontage* Montage, float
 	return AnimInstance->Montage_Play(Montage, PlayRate);
 }
 
+void AGCBaseCharacter::ApplyQueuedDamage(const FQueuedDamage& QueuedDamage)
+{
+	const UDamageType* DamageType = QueuedDamage.DamageType.Get();
+	AController* InstigatedBy = QueuedDamage.InstigatedBy.Get();
+	AActor* DamageCauser = QueuedDamage.DamageCauser.Get();
+	CharacterAttributesComponent->OnTakeAnyDamage(this, QueuedDamage.Damage, DamageType, InstigatedBy, DamageCauser);
+	ReactToDamage(this, QueuedDamage.Damage, DamageType, InstigatedBy, DamageCauser);
+}
+
 void AGCBaseCharacter::ReactToDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
 	AController* InstigatedBy, AActor* DamageCauser)
 {
@@ -6,6 +6,8 @@
 #include "Components/Character/CharacterAttributesComponent.h"
 #include "Data/AITypesGC.h"
 #include "Data/CharacterTypes.h"
+#include "Data/HitboxSettings.h"
+#include "Data/ShotPacket.h"
 #include "Data/Movement/MantlingSettings.h"
 #include "Data/Movement/ZiplineParams.h"
 
@@ -14,6 +16,7 @@
 #include "GameCode/Components/Movement/GCBaseCharacterMovementComponent.h"
 #include "GameFramework/Character.h"
 #include "Interfaces/Killable.h"
+#include "Interfaces/QueuedDamageReceiver.h"
 #include "GCBaseCharacter.generated.h"
 
 class AEquippableItem;
@@ -25,7 +28,7 @@ class UCharacterAttributesComponent;
 class AInteractiveActor;
 
 UCLASS(Abstract, NotBlueprintable)
-class GAMECODE_API AGCBaseCharacter : public ACharacter, public IGenericTeamAgentInterface, public IKillable
+class GAMECODE_API AGCBaseCharacter : public ACharacter, public IGenericTeamAgentInterface, public IKillable, public IQueuedDamageReceiver
 {
 	GENERATED_BODY()
 // ))
@@ -35,9 +38,13 @@ friend UGCBaseCharacterMovementComponent;
 public:
 	AGCBaseCharacter(const FObjectInitializer& ObjectInitializer);
 
+	virtual void PostInitializeComponents() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character|Controls")
 	float BaseTurnRate = 45.f;
@@ -52,6 +59,7 @@ public:
 	UCharacterEquipmentComponent* GetEquipmentComponent () const { return CharacterEquipmentComponent; }
 	const UGCBaseCharacterMovementComponent* GetGCMovementComponent () const { return GCMovementComponent; }
 	const UCharacterAttributesComponent* GetCharacterAttributesComponent() const { return CharacterAttributesComponent; }
+	const TArray<FHitboxSettings>& GetHitboxes() const { return Hitboxes; }
 
 	mutable FAmmoChangedEvent AmmoChangedEvent;
 	
@@ -124,6 +132,29 @@ public:
 	virtual FGenericTeamId GetGenericTeamId() const override { return FGenericTeamId((uint8)Team); }
 
 	virtual bool IsAlive() const override { return CharacterAttributesComponent->IsAlive(); }
+	virtual void ApplyQueuedDamage(const FQueuedDamage& QueuedDamage) override;
+
+	// Shots of the equipped range weapon fired by the owning client during one frame
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_Shoot(const TArray<FShotPacket>& Packets);
+
+	// Cosmetics only, skipped by the shooter who already played them. Sent once per frame of shots
+	UFUNCTION(NetMulticast, Unreliable)
+	void Multicast_ShotsFired(uint8 FireModeIndex, uint8 ShotsCount);
+
+	// Server rejected shots out of its spread sequence, the client continues from the server's state
+	UFUNCTION(Client, Reliable)
+	void Client_SyncSpreadSeed(int32 SpreadSeed);
+
+	// Server keeps its own ammo of client weapons, so it reloads along with the client
+	UFUNCTION(Server, Reliable)
+	void Server_Reload();
+
+	// How far the camera can be from GetPawnViewLocation(), client shots from further are rejected
+	virtual float GetMaxCameraDistance() const { return 0.f; }
+
+	// Chosen by the server, weapon spread streams are seeded from it so the server and the owning client start in sync
+	int32 GetSpreadSeedBase() const { return SpreadSeedBase; }
 	
 protected:
 
@@ -247,14 +278,20 @@ protected:
 
 	float PlayAnimMontageWithDuration(UAnimMontage* Montage, float DesiredDuration);
 
-	UFUNCTION()
 	void ReactToDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
 		AController* InstigatedBy, AActor* DamageCauser);
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	ETeam Team = ETeam::GoodGuys;
+
+	// Recorded on server for lag compensated hitscan. Without hitboxes the capsule is used
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character|Hitboxes")
+	TArray<FHitboxSettings> Hitboxes;
 	
 private:
+	UPROPERTY(Replicated)
+	int32 SpreadSeedBase = 0;
+
 	bool bSprintRequested = false;
 	void TryChangeSprintState();
 	
@@ -301,6 +301,14 @@ void APlayerCharacter::OnAimingEnd_Implementation()
 	}
 }
 
+float APlayerCharacter::GetMaxCameraDistance() const
+{
+	// sprinting pulls the arm out to SprintSpringArmOffset, wallrun and crouch shift the arm and its target
+	const float ArmLength = FMath::Max(SpringArmComponent->TargetArmLength, SprintSpringArmOffset);
+	return SpringArmComponent->GetRelativeLocation().Size() + ArmLength
+		+ SpringArmComponent->TargetOffset.Size() + SpringArmComponent->SocketOffset.Size();
+}
+
 void APlayerCharacter::SetSpringArmPosition(float Alpha) const
 {
 	SpringArmComponent->TargetArmLength = FMath::Lerp(DefaultSpringArmOffset, SprintSpringArmOffset, Alpha);
@@ -32,6 +32,8 @@ public:
 	virtual void ClimbUp(float Value) override;
 	virtual void ClimbDown (float Value) override;
 	virtual void OnJumped_Implementation() override;
+
+	virtual float GetMaxCameraDistance() const override;
 		
 protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
@@ -5,7 +5,9 @@
 
 #include "Components/SphereComponent.h"
 #include "GameCode/Components/Movement/SpiderPawnMovementComponent.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "Utils/DebugUtils.h"
+#include "Utils/GCTraceUtils.h"
+#include "GameCode.h"
 
 ASpiderPawn::ASpiderPawn()
 {
@@ -22,6 +24,7 @@ ASpiderPawn::ASpiderPawn()
 
 void ASpiderPawn::Tick(float DeltaSeconds)
 {
+	GC_TRACE_SCOPE(ASpiderPawn_Tick);
 	Super::Tick(DeltaSeconds);
 	float rffo = GetIkOffsetForSocket(RightFrontFootSocketName);
 	IKRightFrontFootOffset = FMath::FInterpTo(IKRightFrontFootOffset,rffo,DeltaSeconds, IKInterpSpeed);
@@ -45,11 +48,12 @@ float ASpiderPawn::GetIkOffsetForSocket(const FName& SocketName)
 	FVector TraceStart(SocketLocation.X, SocketLocation.Y, GetActorLocation().Z);
 	//approximate. IKTraceDistance is actually collision sphere radius which is expected to end at foot level (see related BP)
 	FVector FootPosition = TraceStart - IKTraceDistance * FVector::UpVector;
-	ETraceTypeQuery TraceType = UEngineTypes::ConvertToTraceType(ECC_Visibility);
 	FHitResult HitResult;
+	GCTraceUtils::FTraceParams TraceParams(GCDebug::IsCategoryEnabled(EGCDebugCategory::Movement));
+	TraceParams.DrawTime = -1.f;
 	
-	bool bHit = UKismetSystemLibrary::LineTraceSingle(GetWorld(), TraceStart, FootPosition - IKTraceExtendDistance * FVector::UpVector,
-		TraceType, true,TArray<AActor*>(), EDrawDebugTrace::ForOneFrame, HitResult, true);
+	bool bHit = GCTraceUtils::LineTraceSingleByChannel(GetWorld(), HitResult, TraceStart,
+		FootPosition - IKTraceExtendDistance * FVector::UpVector, ECC_Visibility, IkQueryParams.Get(this), TraceParams);
 
 	return bHit
 		? (FootPosition.Z - HitResult.Location.Z) / IKScale
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GCBasePawn.h"
+#include "Utils/GCTraceUtils.h"
 #include "SpiderPawn.generated.h"
 
 /**
@@ -67,5 +68,6 @@ private:
 	
 	float IKTraceDistance = 0;
 	float IKScale = 1;
+	GCTraceUtils::FOwnerChainQueryParams IkQueryParams = GCTraceUtils::FOwnerChainQueryParams(FName("SpiderIkTrace"), true);
 	float GetIkOffsetForSocket(const FName& SocketName);
 };
@@ -8,6 +8,7 @@
 #include "DrawDebugHelpers.h"
 #include "GameCode/Characters/GCBaseCharacter.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameCode/GameCode.h"
 
 UCharacterAttributesComponent::UCharacterAttributesComponent()
 {
@@ -27,6 +28,7 @@ void UCharacterAttributesComponent::BeginPlay()
 
 void UCharacterAttributesComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	GC_TRACE_SCOPE(UCharacterAttributesComponent_TickComponent);
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 	if (Health > 0.f)
 	{
@@ -6,9 +6,12 @@
 #include "Actors/Equipment/Weapons/ThrowableItem.h"
 #include "Actors/Equipment/Weapons/RangeWeaponItem.h"
 #include "Actors/Projectiles/GCProjectile.h"
+#include "GameCode.h"
 #include "Characters/GCBaseCharacter.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
+#include "Subsystems/GCFXSubsystem.h"
+#include "Utils/DebugUtils.h"
 
 // TODO CombatComponent after InventoryComponent
 
@@ -53,6 +56,7 @@ void UCharacterEquipmentComponent::CreateLoadout()
 
 void UCharacterEquipmentComponent::PickUpWeapon(EEquipmentSlot Slot, const TSubclassOf<AEquippableItem>& WeaponClass)
 {
+	GC_LLM_SCOPE(Equipment);
 	FActorSpawnParameters ActorSpawnParameters;
 	ActorSpawnParameters.Owner = GetOwner();
 	AEquippableItem* Weapon = GetWorld()->SpawnActor<AEquippableItem>(WeaponClass, ActorSpawnParameters);
@@ -60,6 +64,7 @@ void UCharacterEquipmentComponent::PickUpWeapon(EEquipmentSlot Slot, const TSubc
 	if (Weapon->IsRangedWeapon())
 	{
 		ARangeWeaponItem* RangeWeapon = StaticCast<ARangeWeaponItem*>(Weapon);
+		RangeWeapon->InitializeSpreadStream(HashCombine(CharacterOwner->GetSpreadSeedBase(), (uint32)Slot));
 		RangeWeapon->ShootEvent.AddUObject(this, &UCharacterEquipmentComponent::OnShot);
 		RangeWeapon->AmmoChangedEvent.BindUObject(this, &UCharacterEquipmentComponent::OnAmmoChanged);
 		RangeWeapon->OutOfAmmoEvent.BindLambda([this](){ if (bAutoReload) TryReload(); });
@@ -99,6 +104,7 @@ void UCharacterEquipmentComponent::DropItem()
 
 void UCharacterEquipmentComponent::PickUpThrowable(EThrowableType ThrowableType, const TSubclassOf<AThrowableItem>& ThrowableClass)
 {
+	GC_LLM_SCOPE(Equipment);
 	FActorSpawnParameters ActorSpawnParameters;
 	ActorSpawnParameters.Owner = GetOwner();
 	AThrowableItem* Throwable = GetWorld()->SpawnActor<AThrowableItem>(ThrowableClass, ActorSpawnParameters);
@@ -157,8 +163,11 @@ void UCharacterEquipmentComponent::EquipWeapon(EEquipmentSlot EquipmentSlot)
 		}
 		else
 		{
-		    GEngine->AddOnScreenDebugMessage(INDEX_NONE, 2, FColor::Yellow,
-		    	FString::Printf(TEXT("Changing weapon without animation in %fs"), EquipmentDuration), true);
+			if (GCDebug::IsCategoryEnabled(EGCDebugCategory::Equipment))
+			{
+				GCDebug::AddMessage(INDEX_NONE, 2, FColor::Yellow,
+					FString::Printf(TEXT("Changing weapon without animation in %fs"), EquipmentDuration));
+			}
 		}
 		
 		GetWorld()->GetTimerManager().SetTimer(ChangingEquipmentTimer, this, &UCharacterEquipmentComponent::OnWeaponsChanged, EquipmentDuration);
@@ -312,6 +321,30 @@ void UCharacterEquipmentComponent::StartShooting(AController* Controller)
 	}
 }
 
+void UCharacterEquipmentComponent::ReplayShots(TArrayView<const FShotPacket> Packets) const
+{
+	if (IsValid(EquippedRangedWeapon))
+	{
+		EquippedRangedWeapon->ReplayShots(Packets, CharacterOwner->GetController());
+	}
+}
+
+void UCharacterEquipmentComponent::PlayRemoteShots(uint8 FireModeIndex, int32 ShotsCount) const
+{
+	if (IsValid(EquippedRangedWeapon))
+	{
+		EquippedRangedWeapon->PlayRemoteShots(FireModeIndex, ShotsCount);
+	}
+}
+
+void UCharacterEquipmentComponent::SyncSpreadSeed(int32 SpreadSeed) const
+{
+	if (IsValid(EquippedRangedWeapon))
+	{
+		EquippedRangedWeapon->SetSpreadSeed(SpreadSeed);
+	}
+}
+
 void UCharacterEquipmentComponent::StopFiring() const
 {
 	if (IsValid(EquippedRangedWeapon))
@@ -356,6 +389,11 @@ bool UCharacterEquipmentComponent::CanReload()
 void UCharacterEquipmentComponent::TryReload()
 {
 	if (!CanReload()) return;
+
+	if (!CharacterOwner->HasAuthority())
+	{
+		CharacterOwner->Server_Reload();
+	}
 	
 	bReloading = true;
 	CharacterOwner->OnActionStarted(ECharacterAction::Reload);
@@ -489,10 +527,7 @@ void UCharacterEquipmentComponent::StartTogglingFireMode()
 		CharacterOwner->PlayAnimMontageWithDuration(FireModeSettings.SwitchMontage, FireModeSettings.SwitchDuration);
 	}
 
-	if (IsValid(FireModeSettings.ChangeSFX))
-	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), FireModeSettings.ChangeSFX, EquippedRangedWeapon->GetActorLocation());
-	}
+	GetWorld()->GetSubsystem<UGCFXSubsystem>()->PlaySoundAtLocation(FireModeSettings.ChangeSFX, EquippedRangedWeapon->GetActorLocation());
 	
 	EquippedRangedWeapon->StartTogglingFireMode();
 	CharacterOwner->OnActionStarted(ECharacterAction::ToggleFireMode);
@@ -9,6 +9,7 @@
 #include "Data/EquipmentData.h"
 #include "Data/EquipmentTypes.h"
 #include "Data/MeleeAttackData.h"
+#include "Data/ShotPacket.h"
 #include "Data/UserInterfaceTypes.h"
 #include "CharacterEquipmentComponent.generated.h"
 
@@ -43,6 +44,9 @@ public:
 	
 	void StartShooting(AController* Controller);
 	void StopFiring() const;
+	void ReplayShots(TArrayView<const FShotPacket> Packets) const;
+	void PlayRemoteShots(uint8 FireModeIndex, int32 ShotsCount) const;
+	void SyncSpreadSeed(int32 SpreadSeed) const;
 
 	bool IsPreferStrafing() const;
 
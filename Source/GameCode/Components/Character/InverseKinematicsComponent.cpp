@@ -2,11 +2,12 @@
 
 
 #include "InverseKinematicsComponent.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "GameCode/GameCode.h"
 
 void UInverseKinematicsComponent::CalculateIkData(const USkeletalMeshComponent* SkeletalMesh, float CapsuleHalfHeight,
 	FVector ActorLocation, bool bCrouched, float DeltaTime)
 {
+	GC_TRACE_SCOPE(UInverseKinematicsComponent_CalculateIkData);
 	UpdateLegsIkOffsetsBoxTrace(SkeletalMesh, CapsuleHalfHeight, ActorLocation, bCrouched, DeltaTime);
 }
 
@@ -115,13 +116,11 @@ float UInverseKinematicsComponent::GetIkElevationForSocket(const FName& SocketNa
 	FVector TraceStart(FootLocation.X, FootLocation.Y, ActorLocation.Z - CapsuleHalfHeight + TraceDistance);
 	FVector TraceEnd = TraceStart - (TraceDistance + IkSettings.TraceExtend) * FVector::UpVector;
 	FHitResult HitResult;
-	ETraceTypeQuery TraceType = UEngineTypes::ConvertToTraceType(ECC_Visibility);
 
 	FVector FootHalfSize(1,  IkSettings.FootLength * 0.5f, IkSettings.FootWidth);
 	
-	bool bHit = UKismetSystemLibrary::BoxTraceSingle(this, TraceStart, TraceEnd, FootHalfSize,
-		FootRotation, TraceType, true,TArray<AActor*>(),
-		EDrawDebugTrace::None, HitResult, true);
+	bool bHit = GCTraceUtils::SweepBoxSingleByChannel(GetWorld(), HitResult, TraceStart, TraceEnd, FootHalfSize,
+		ECC_Visibility, IkTraceQueryParams.Get(GetOwner()), GCTraceUtils::FTraceParams(), FootRotation.Quaternion());
 	
 	return bHit
 		? (HitResult.Location.Z - (ActorLocation.Z - CapsuleHalfHeight)) / IkData.IKScale
@@ -135,21 +134,19 @@ float UInverseKinematicsComponent::CalculateFootPitch(const USkeletalMeshCompone
 	const FVector ToesLocation = SkeletalMesh->GetSocketLocation(ToesSocketName);
 	const FVector FootLocation = SkeletalMesh->GetSocketLocation(FootSocketName);
 	FHitResult HitResult;
-	ETraceTypeQuery TraceType = UEngineTypes::ConvertToTraceType(ECC_Visibility);
+	const UWorld* World = GetWorld();
+	const FCollisionQueryParams& QueryParams = IkTraceQueryParams.Get(GetOwner());
 	
-	bool bHeelHit = UKismetSystemLibrary::LineTraceSingle(this, HeelLocation,
-		HeelLocation - FVector::UpVector * IkSettings.FootLength, TraceType,true,TArray<AActor*>(),
-		EDrawDebugTrace::None, HitResult, true);
+	bool bHeelHit = GCTraceUtils::LineTraceSingleByChannel(World, HitResult, HeelLocation,
+		HeelLocation - FVector::UpVector * IkSettings.FootLength, ECC_Visibility, QueryParams, GCTraceUtils::FTraceParams());
 	float HeelDistance = bHeelHit ? HitResult.Location.Z - HeelLocation.Z : 0;
 
-	bool bToesHit = UKismetSystemLibrary::LineTraceSingle(this, ToesLocation,
-		ToesLocation - FVector::UpVector * IkSettings.FootLength, TraceType,true,TArray<AActor*>(),
-		EDrawDebugTrace::None, HitResult, true);
+	bool bToesHit = GCTraceUtils::LineTraceSingleByChannel(World, HitResult, ToesLocation,
+		ToesLocation - FVector::UpVector * IkSettings.FootLength, ECC_Visibility, QueryParams, GCTraceUtils::FTraceParams());
 	float ToesDistance = bToesHit ? HitResult.Location.Z - ToesLocation.Z : 0;
 
-	bool bFootHit = UKismetSystemLibrary::LineTraceSingle(this, FootLocation,
-		FootLocation - FVector::UpVector * IkSettings.FootLength, TraceType,true,TArray<AActor*>(),
-		EDrawDebugTrace::None, HitResult, true);
+	bool bFootHit = GCTraceUtils::LineTraceSingleByChannel(World, HitResult, FootLocation,
+		FootLocation - FVector::UpVector * IkSettings.FootLength, ECC_Visibility, QueryParams, GCTraceUtils::FTraceParams());
 	float FootDistance = bFootHit ? HitResult.Location.Z - FootLocation.Z : 0;
 
 	if (!(bHeelHit || bToesHit || bFootHit))
@@ -6,6 +6,7 @@
 #include "Components/ActorComponent.h"
 #include "GameCode/Data/Movement/IKData.h"
 #include "GameCode/Data/Movement/IKSettings.h"
+#include "Utils/GCTraceUtils.h"
 
 #include "InverseKinematicsComponent.generated.h"
 
@@ -27,6 +28,7 @@ protected:
 	
 private:
 	FIkData IkData;
+	GCTraceUtils::FOwnerChainQueryParams IkTraceQueryParams = GCTraceUtils::FOwnerChainQueryParams(FName("IkTrace"), true);
 
 	void RecalculateFeetPitches(const USkeletalMeshComponent* SkeletalMesh, float DeltaSeconds);
 	void RecalculateKneesExtends(float DeltaSeconds);
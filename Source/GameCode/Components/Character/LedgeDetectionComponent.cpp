@@ -6,11 +6,15 @@
 #include "DrawDebugHelpers.h"
 #include "Components/CapsuleComponent.h"
 #include "GameCode/GameCode.h"
-#include "GameCode/GCDebugSubsystem.h"
-#include "GameCode/GCGameInstance.h"
+#include "GameCode/Utils/DebugUtils.h"
 #include "GameCode/Utils/GCTraceUtils.h"
 #include "GameFramework/Character.h"
-#include "Kismet/GameplayStatics.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+ULedgeDetectionComponent::ULedgeDetectionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+}
 
 void ULedgeDetectionComponent::BeginPlay()
 {
@@ -18,51 +22,83 @@ void ULedgeDetectionComponent::BeginPlay()
 	
 	checkf(GetOwner()->IsA<ACharacter>(), TEXT("LedgeDetectionComponent intended to be used with ACharacter derivatives"));
 	CharacterOwner = StaticCast<ACharacter*>(GetOwner());
+
+	ForwardProbeDelegate.BindUObject(this, &ULedgeDetectionComponent::OnForwardProbeCompleted);
+	SetComponentTickInterval(SpeculativeProbeInterval);
+	SetComponentTickEnabled(bSpeculativeProbeEnabled);
 }
 
-bool ULedgeDetectionComponent::DetectLedge(FLedgeDescriptor& LedgeDescriptor)
+void ULedgeDetectionComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction)
 {
-	const UCapsuleComponent* CharacterCapsule = CharacterOwner->GetClass()->GetDefaultObject<ACharacter>()->GetCapsuleComponent();
-	const float BottomZOffset = 2.f;
-	const FVector CharacterBottom = CharacterOwner->GetActorLocation()
-		- (CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() - BottomZOffset) * FVector::UpVector;
-	
-#if ENABLE_DRAW_DEBUG
-	bool bDebugEnabled = GetDebugSubsystem()->IsDebugCategoryEnabled(DebugCategoryLedgeDetection);
-#else
-	bool bDebugEnabled = false;
-#endif
-
-	const GCTraceUtils::FTraceParams TraceParams(bDebugEnabled);
+	GC_TRACE_SCOPE(ULedgeDetectionComponent_TickComponent);
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (!bProbeInFlight && ShouldProbe())
+	{
+		RequestForwardProbe();
+	}
+}
 
-	FCollisionQueryParams CollisionQueryParams;
-	CollisionQueryParams.bTraceComplex = true;
-	CollisionQueryParams.AddIgnoredActor(CharacterOwner);
-	
-	const float ForwardCheckCapsuleRadius = CharacterCapsule->GetScaledCapsuleRadius();
-	const float ForwardCheckCapsuleHalfHeight = (MaxLedgeHeight - MinLedgeHeight) * 0.5f;
+bool ULedgeDetectionComponent::DetectLedge(FLedgeDescriptor& LedgeDescriptor)
+{
+	GC_TRACE_SCOPE(ULedgeDetectionComponent_DetectLedge);
+	const FVector CharacterBottom = GetCharacterBottom();
+	const GCTraceUtils::FTraceParams TraceParams(IsDebugEnabled());
+	const FCollisionQueryParams& CollisionQueryParams = LedgeQueryParams.Get(CharacterOwner);
 
-	FVector ForwardSweepStartLocation = CharacterBottom + (MinLedgeHeight + ForwardCheckCapsuleHalfHeight) * FVector::UpVector;
-	FVector ForwardSweepEndLocation = ForwardSweepStartLocation + CharacterOwner->GetActorForwardVector() * ForwardCheckDistance;
+	FVector ForwardSweepStartLocation, ForwardSweepEndLocation;
+	FCollisionShape ForwardCheckCapsule;
+	GetForwardSweep(CharacterBottom, ForwardSweepStartLocation, ForwardSweepEndLocation, ForwardCheckCapsule);
 	
 	FHitResult ForwardCheckHitResult;
 
 	bool bForwardHit = GCTraceUtils::SweepCapsuleSingleByChannel(GetWorld(), ForwardCheckHitResult,
-		ForwardSweepStartLocation, ForwardSweepEndLocation, ForwardCheckCapsuleRadius, ForwardCheckCapsuleHalfHeight,
-		ECC_Climbable, CollisionQueryParams, TraceParams);
+		ForwardSweepStartLocation, ForwardSweepEndLocation, ForwardCheckCapsule.GetCapsuleRadius(),
+		ForwardCheckCapsule.GetCapsuleHalfHeight(), ECC_Climbable, CollisionQueryParams, TraceParams);
 	if (!bForwardHit)
 	{
 		return false;
 	}
 
+	return DetectLedgeFromForwardHit(ForwardCheckHitResult, CharacterBottom, CollisionQueryParams, TraceParams, LedgeDescriptor);
+}
+
+bool ULedgeDetectionComponent::ConsumeLedge(FLedgeDescriptor& LedgeDescriptor)
+{
+	return TryConsumeCachedLedge(LedgeDescriptor) || DetectLedge(LedgeDescriptor);
+}
+
+FVector ULedgeDetectionComponent::GetCharacterBottom() const
+{
+	const float BottomZOffset = 2.f;
+	return CharacterOwner->GetActorLocation()
+		- (CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() - BottomZOffset) * FVector::UpVector;
+}
+
+void ULedgeDetectionComponent::GetForwardSweep(const FVector& CharacterBottom, FVector& OutStart, FVector& OutEnd,
+	FCollisionShape& OutShape) const
+{
+	const UCapsuleComponent* CharacterCapsule = CharacterOwner->GetClass()->GetDefaultObject<ACharacter>()->GetCapsuleComponent();
+	const float ForwardCheckCapsuleHalfHeight = (MaxLedgeHeight - MinLedgeHeight) * 0.5f;
+	OutShape = FCollisionShape::MakeCapsule(CharacterCapsule->GetScaledCapsuleRadius(), ForwardCheckCapsuleHalfHeight);
+	OutStart = CharacterBottom + (MinLedgeHeight + ForwardCheckCapsuleHalfHeight) * FVector::UpVector;
+	OutEnd = OutStart + CharacterOwner->GetActorForwardVector() * ForwardCheckDistance;
+}
+
+bool ULedgeDetectionComponent::DetectLedgeFromForwardHit(const FHitResult& ForwardCheckHitResult, const FVector& CharacterBottom,
+	const FCollisionQueryParams& CollisionQueryParams, const GCTraceUtils::FTraceParams& TraceParams,
+	FLedgeDescriptor& LedgeDescriptor)
+{
+	const UCapsuleComponent* CharacterCapsule = CharacterOwner->GetClass()->GetDefaultObject<ACharacter>()->GetCapsuleComponent();
+	const float BottomZOffset = 2.f;
+	const float ForwardCheckCapsuleRadius = CharacterCapsule->GetScaledCapsuleRadius();
+	
 	FHitResult LedgeApproachHitResult;
 	FVector LedgeApproachTraceStart = ForwardCheckHitResult.Location;
 	LedgeApproachTraceStart.Z = CharacterBottom.Z + CharacterCapsule->GetScaledCapsuleHalfHeight() * 2 + CharacterCapsule->GetScaledCapsuleRadius();
 	FVector LedgeApproachTraceEnd = CharacterBottom + BottomZOffset * FVector::UpVector;
-	ETraceTypeQuery TraceType = UEngineTypes::ConvertToTraceType(ECC_Visibility);
-	bool bCantApproachLedge = UKismetSystemLibrary::LineTraceSingle(this, LedgeApproachTraceStart,
-    		LedgeApproachTraceEnd, TraceType,true,TArray<AActor*>(),
-    		EDrawDebugTrace::None, LedgeApproachHitResult, true);
+	bool bCantApproachLedge = GCTraceUtils::LineTraceSingleByChannel(GetWorld(), LedgeApproachHitResult,
+		LedgeApproachTraceStart, LedgeApproachTraceEnd, ECC_Visibility, CollisionQueryParams, GCTraceUtils::FTraceParams());
 
 	if (bCantApproachLedge)
 	{
@@ -87,7 +123,6 @@ bool ULedgeDetectionComponent::DetectLedge(FLedgeDescriptor& LedgeDescriptor)
 
 	const float OverlapCapsuleRadius = CharacterCapsule->GetScaledCapsuleRadius();
 	const float OverlapCapsuleHalfHeight = CharacterCapsule->GetScaledCapsuleHalfHeight();
-	FCollisionShape OverlapCapsuleShape = FCollisionShape::MakeCapsule(OverlapCapsuleRadius, OverlapCapsuleHalfHeight);
 	FVector OverlapLocation = DownwardCheckHitResult.ImpactPoint + (OverlapCapsuleHalfHeight + BottomZOffset) * FVector::UpVector;
 	
 	bool bOverlap = GCTraceUtils::OverlapCapsuleBlockingByProfile(GetWorld(), OverlapLocation, OverlapCapsuleRadius,
@@ -106,12 +141,117 @@ bool ULedgeDetectionComponent::DetectLedge(FLedgeDescriptor& LedgeDescriptor)
 	return true;
 }
 
-UGCDebugSubsystem* ULedgeDetectionComponent::GetDebugSubsystem()
+#pragma region SPECULATIVE_PROBE
+
+bool ULedgeDetectionComponent::ShouldProbe() const
 {
-	if (!IsValid(DebugSubsystem))
+	if (!IsValid(CharacterOwner) || CharacterOwner->GetCharacterMovement()->MovementMode == MOVE_Custom)
 	{
-		DebugSubsystem = UGameplayStatics::GetGameInstance(GetWorld())->GetSubsystem<UGCDebugSubsystem>();
+		return false;
 	}
+	
+	const FVector Velocity = CharacterOwner->GetVelocity();
+	return Velocity.SizeSquared2D() >= MinProbeSpeed * MinProbeSpeed
+		&& FVector::DotProduct(Velocity.GetSafeNormal2D(), CharacterOwner->GetActorForwardVector()) >= ProbeMinForwardDot;
+}
 
-	return DebugSubsystem;
-}
\ No newline at end of file
+void ULedgeDetectionComponent::RequestForwardProbe()
+{
+	ProbeCharacterLocation = CharacterOwner->GetActorLocation();
+	ProbeCharacterBottom = GetCharacterBottom();
+	
+	FVector SweepStart, SweepEnd;
+	FCollisionShape SweepShape;
+	GetForwardSweep(ProbeCharacterBottom, SweepStart, SweepEnd, SweepShape);
+	
+	GC_COUNT_TRACES(1);
+	GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, SweepStart, SweepEnd, FQuat::Identity, ECC_Climbable,
+		SweepShape, LedgeQueryParams.Get(CharacterOwner), FCollisionResponseParams::DefaultResponseParam, &ForwardProbeDelegate);
+	bProbeInFlight = true;
+}
+
+void ULedgeDetectionComponent::OnForwardProbeCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	GC_TRACE_SCOPE(ULedgeDetectionComponent_OnForwardProbeCompleted);
+	bProbeInFlight = false;
+	bHasCachedLedge = false;
+	if (!IsValid(CharacterOwner))
+	{
+		return;
+	}
+	
+	const FHitResult* ForwardHit = TraceDatum.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	if (ForwardHit == nullptr)
+	{
+		return;
+	}
+
+	// rest of the pipeline is cheap and only runs when there's actually climbable geometry ahead
+	FLedgeDescriptor LedgeDescriptor;
+	const GCTraceUtils::FTraceParams TraceParams(IsDebugEnabled());
+	if (!DetectLedgeFromForwardHit(*ForwardHit, ProbeCharacterBottom, LedgeQueryParams.Get(CharacterOwner), TraceParams, LedgeDescriptor))
+	{
+		return;
+	}
+
+	CachedLedge = LedgeDescriptor;
+	CachedMantleTarget = LedgeDescriptor.MantleTarget;
+	CachedMantleTargetLocation = IsValid(LedgeDescriptor.MantleTarget) ? LedgeDescriptor.MantleTarget->GetActorLocation() : FVector::ZeroVector;
+	CachedLedgeProbeLocation = ProbeCharacterLocation;
+	CachedLedgeTopZ = ProbeCharacterBottom.Z + LedgeDescriptor.MantlingHeight;
+	CachedLedgeTime = GetWorld()->GetTimeSeconds();
+	bHasCachedLedge = true;
+}
+
+bool ULedgeDetectionComponent::TryConsumeCachedLedge(FLedgeDescriptor& LedgeDescriptor)
+{
+	if (!bHasCachedLedge)
+	{
+		return false;
+	}
+
+	// one shot, whatever the outcome
+	bHasCachedLedge = false;
+	
+	if (GetWorld()->GetTimeSeconds() - CachedLedgeTime > CachedLedgeLifetime
+		|| FVector::DistSquared(CharacterOwner->GetActorLocation(), CachedLedgeProbeLocation) > CachedLedgeMaxDrift * CachedLedgeMaxDrift
+		|| FVector::DotProduct(CharacterOwner->GetActorForwardVector(), -CachedLedge.LedgeNormal.GetSafeNormal2D()) < ProbeMinForwardDot)
+	{
+		return false;
+	}
+
+	// mantle target got destroyed or moved since the probe
+	if (CachedMantleTarget.IsStale()
+		|| (CachedMantleTarget.IsValid() && !CachedMantleTarget->GetActorLocation().Equals(CachedMantleTargetLocation, 1.f)))
+	{
+		return false;
+	}
+
+	const float MantlingHeight = CachedLedgeTopZ - GetCharacterBottom().Z;
+	if (MantlingHeight < MinLedgeHeight || MantlingHeight > MaxLedgeHeight)
+	{
+		return false;
+	}
+	
+	// something could have moved into the spot
+	const UCapsuleComponent* CharacterCapsule = CharacterOwner->GetClass()->GetDefaultObject<ACharacter>()->GetCapsuleComponent();
+	bool bOverlap = GCTraceUtils::OverlapCapsuleBlockingByProfile(GetWorld(), CachedLedge.Location,
+		CharacterCapsule->GetScaledCapsuleRadius(), CharacterCapsule->GetScaledCapsuleHalfHeight(), ProfilePawn,
+		LedgeQueryParams.Get(CharacterOwner), GCTraceUtils::FTraceParams(IsDebugEnabled()));
+	if (bOverlap)
+	{
+		return false;
+	}
+	
+	LedgeDescriptor = CachedLedge;
+	LedgeDescriptor.MantleTarget = CachedMantleTarget.Get();
+	LedgeDescriptor.MantlingHeight = MantlingHeight;
+	return true;
+}
+
+#pragma endregion SPECULATIVE_PROBE
+
+bool ULedgeDetectionComponent::IsDebugEnabled() const
+{
+	return GCDebug::IsCategoryEnabled(EGCDebugCategory::LedgeDetection);
+}
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "Utils/GCTraceUtils.h"
 #include "LedgeDetectionComponent.generated.h"
 
 USTRUCT(BlueprintType)
@@ -33,7 +35,14 @@ class GAMECODE_API ULedgeDetectionComponent : public UActorComponent
 	GENERATED_BODY()
 
 public:
+	ULedgeDetectionComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	
 	bool DetectLedge(OUT FLedgeDescriptor& LedgeDescriptor);
+
+	// Uses the ledge found by the speculative probe if it's still valid, falls back to DetectLedge otherwise
+	bool ConsumeLedge(OUT FLedgeDescriptor& LedgeDescriptor);
 	
 protected:
 	// Called when the game starts
@@ -46,11 +55,60 @@ protected:
 	float MaxLedgeHeight = 200.f;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings", meta=(UIMin=0.0f, ClampMin=0.0f))
-	float ForwardCheckDistance = 50.f;	
+	float ForwardCheckDistance = 50.f;
+
+	// Probe for ledges in background while character moves forward so that mantle doesn't pay for detection on input
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Speculative probe")
+	bool bSpeculativeProbeEnabled = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Speculative probe", meta=(UIMin=0.0f, ClampMin=0.0f, EditCondition="bSpeculativeProbeEnabled"))
+	float SpeculativeProbeInterval = 0.1f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Speculative probe", meta=(UIMin=0.0f, ClampMin=0.0f, EditCondition="bSpeculativeProbeEnabled"))
+	float MinProbeSpeed = 50.f;
+
+	// Cos of max angle between velocity and character forward for probe to run. Also used to validate cached ledge against character facing
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Speculative probe", meta=(UIMin=0.0f, ClampMin=0.0f, UIMax=1.0f, ClampMax=1.0f, EditCondition="bSpeculativeProbeEnabled"))
+	float ProbeMinForwardDot = 0.5f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Speculative probe", meta=(UIMin=0.0f, ClampMin=0.0f, EditCondition="bSpeculativeProbeEnabled"))
+	float CachedLedgeLifetime = 0.25f;
+
+	// How far character can move from where the probe ran for the cached ledge to be still trusted
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Speculative probe", meta=(UIMin=0.0f, ClampMin=0.0f, EditCondition="bSpeculativeProbeEnabled"))
+	float CachedLedgeMaxDrift = 40.f;
 
 private:
 	class ACharacter* CharacterOwner;
-	class UGCDebugSubsystem* DebugSubsystem;
+	GCTraceUtils::FOwnerChainQueryParams LedgeQueryParams = GCTraceUtils::FOwnerChainQueryParams(FName("LedgeDetection"), true);
+
+	bool IsDebugEnabled() const;
+
+	FVector GetCharacterBottom() const;
+	void GetForwardSweep(const FVector& CharacterBottom, FVector& OutStart, FVector& OutEnd, FCollisionShape& OutShape) const;
+	bool DetectLedgeFromForwardHit(const FHitResult& ForwardCheckHitResult, const FVector& CharacterBottom,
+		const FCollisionQueryParams& CollisionQueryParams, const GCTraceUtils::FTraceParams& TraceParams,
+		FLedgeDescriptor& LedgeDescriptor);
+
+#pragma region SPECULATIVE_PROBE
+	
+	bool ShouldProbe() const;
+	void RequestForwardProbe();
+	void OnForwardProbeCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	bool TryConsumeCachedLedge(FLedgeDescriptor& LedgeDescriptor);
+
+	FTraceDelegate ForwardProbeDelegate;
+	bool bProbeInFlight = false;
+	FVector ProbeCharacterLocation = FVector::ZeroVector;
+	FVector ProbeCharacterBottom = FVector::ZeroVector;
+
+	bool bHasCachedLedge = false;
+	FLedgeDescriptor CachedLedge;
+	TWeakObjectPtr<AActor> CachedMantleTarget;
+	FVector CachedMantleTargetLocation = FVector::ZeroVector;
+	FVector CachedLedgeProbeLocation = FVector::ZeroVector;
+	float CachedLedgeTopZ = 0.f;
+	float CachedLedgeTime = 0.f;
 
-	UGCDebugSubsystem* GetDebugSubsystem();
+#pragma endregion SPECULATIVE_PROBE
 };
@@ -1,25 +1,89 @@
 #include "BarrelComponent.h"
 
-#include "DrawDebugHelpers.h"
 #include "GameCode.h"
-#include "GCDebugSubsystem.h"
+#include "Async/ParallelFor.h"
 #include "Kismet/GameplayStatics.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraComponent.h"
+#include "NiagaraDataInterfaceArrayFunctionLibrary.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
 #include "Actors/Projectiles/GCProjectile.h"
-#include "Components/DecalComponent.h"
 #include "Sound/SoundCue.h"
+#include "Subsystems/GCDecalSubsystem.h"
+#include "Subsystems/GCFXSubsystem.h"
+#include "Subsystems/GCLagCompensationSubsystem.h"
+#include "Subsystems/GCProjectilePoolSubsystem.h"
+#include "Subsystems/GCProjectileSimulationSubsystem.h"
+#include "Utils/DebugUtils.h"
 
-void UBarrelComponent::Shoot(const FVector& ViewLocation, const FVector& Direction, AController* ShooterController)
+UBarrelComponent::UBarrelComponent()
 {
+	// ticks only while there are tracers to send to PersistentTracerFX
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void UBarrelComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	if (HitRegistrationType == EHitRegistrationType::Projectile && ProjectilePoolPrewarmCount > 0)
+	{
+		GetWorld()->GetSubsystem<UGCProjectilePoolSubsystem>()->Prewarm(ProjectileClass, ProjectilePoolPrewarmCount);
+	}
+
+	if (HitRegistrationType == EHitRegistrationType::HitScan && PenetrationSettings.bEnabled)
+	{
+		PenetrationDamageScales.Init(PenetrationSettings.DefaultDamageScale, SurfaceType_Max);
+		for (const FPenetrationSurface& Surface : PenetrationSettings.Surfaces)
+		{
+			PenetrationDamageScales[Surface.SurfaceType] = Surface.DamageScale;
+		}
+	}
+
+	if (FXPoolPrewarmCount > 0)
+	{
+		UGCFXSubsystem* FXSubsystem = GetWorld()->GetSubsystem<UGCFXSubsystem>();
+		FXSubsystem->PrewarmNiagara(MuzzleFlashFX, FXPoolPrewarmCount);
+		if (!IsValid(PersistentTracerFX))
+		{
+			FXSubsystem->PrewarmNiagara(TraceFX, FXPoolPrewarmCount);
+		}
+	}
+}
+
+void UBarrelComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UGCFXSubsystem* FXSubsystem = GetWorld()->GetSubsystem<UGCFXSubsystem>();
+	if (IsValid(FXSubsystem))
+	{
+		FXSubsystem->ReleaseSoundEmitter(ShotSoundEmitter);
+	}
+	
+	Super::EndPlay(EndPlayReason);
+}
+
+void UBarrelComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	FlushTracers();
+}
+
+void UBarrelComponent::Shoot(const FVector& ViewLocation, const FVector& Direction, AController* ShooterController, float ShotAge,
+	float ShotTime)
+{
+	GC_TRACE_SCOPE(UBarrelComponent_Shoot);
 	bool bHit = false;
 	switch (HitRegistrationType)
 	{
 		case EHitRegistrationType::HitScan:
-			bHit = ShootHitScan(ViewLocation, Direction, ShooterController);
+			bHit = ShootHitScan(ViewLocation, Direction, ShooterController, ShotTime);
 			break;
 		case EHitRegistrationType::Projectile:
-			ShootProjectile(ViewLocation, Direction, ShooterController);
+			ShootProjectile(ViewLocation, Direction, ShooterController, ShotAge);
+			break;
+		case EHitRegistrationType::SimulatedProjectile:
+			ShootSimulatedProjectile(ViewLocation, Direction, ShooterController, ShotAge);
 			break;
 		default:
 			break;
@@ -27,29 +91,36 @@ void UBarrelComponent::Shoot(const FVector& ViewLocation, const FVector& Directi
 }
 
 bool UBarrelComponent::ShootHitScan(const FVector& ViewLocation, const FVector& Direction,
-                                          AController* ShooterController)
+                                          AController* ShooterController, float ShotTime)
 {
-#if ENABLE_DRAW_DEBUG
-	bool bDrawDebugEnabled = GetDebugSubsystem()->IsDebugCategoryEnabled(DebugCategoryRangeWeapons);
-#else
-	bool bDrawDebugEnabled = false;
-#endif
+	if (PenetrationSettings.bEnabled)
+	{
+		return ShootHitScanPenetrating(ViewLocation, Direction, ShooterController, ShotTime);
+	}
+	
+	const bool bDrawDebugEnabled = GCDebug::IsCategoryEnabled(EGCDebugCategory::RangeWeapons);
 
 	FVector ProjectileStartLocation = GetComponentLocation();
 	FVector ProjectileEndLocation = ViewLocation + Range * Direction;
 	const UWorld* World = GetWorld();
 	FHitResult ShotResult;
-	FCollisionQueryParams CollisionQueryParams;
-	CollisionQueryParams.AddIgnoredActor(GetOwner());
-	CollisionQueryParams.AddIgnoredActor(GetOwner()->GetOwner());
-	bool bHit = World->LineTraceSingleByChannel(ShotResult, ViewLocation, ProjectileEndLocation, ECC_Bullet, CollisionQueryParams);
+	const FCollisionQueryParams& CollisionQueryParams = ShotQueryParams.Get(GetOwner());
+	// remote players are validated against characters as they saw them. Local and AI shots trace the current state
+	const UGCLagCompensationSubsystem* LagCompensation = World->GetSubsystem<UGCLagCompensationSubsystem>();
+	if (ShotTime < 0.f)
+	{
+		ShotTime = LagCompensation->GetShotTime(ShooterController);
+	}
+	
+	GC_COUNT_TRACES(2);
+	bool bHit = LagCompensation->LineTraceRewound(ShotTime, ShotResult, ViewLocation, ProjectileEndLocation, ECC_Bullet, CollisionQueryParams);
 	// TODO DotProduct doesnt really solve the problem of shooting behind players back. Need to fix one day
 	if (bHit && FVector::DotProduct(Direction, ShotResult.ImpactPoint - ProjectileStartLocation) > 0.f)
 	{
 		ProjectileEndLocation = ShotResult.ImpactPoint + Direction * 5.f;
 	}
 
-	bHit = World->LineTraceSingleByChannel(ShotResult, ProjectileStartLocation, ProjectileEndLocation, ECC_Bullet, CollisionQueryParams);
+	bHit = LagCompensation->LineTraceRewound(ShotTime, ShotResult, ProjectileStartLocation, ProjectileEndLocation, ECC_Bullet, CollisionQueryParams);
 	if (bHit)
 	{
 		ProjectileEndLocation = ShotResult.ImpactPoint;
@@ -57,32 +128,323 @@ bool UBarrelComponent::ShootHitScan(const FVector& ViewLocation, const FVector&
 		
 		if (bDrawDebugEnabled)
 		{
-			DrawDebugSphere(World, ProjectileEndLocation, 10.f, 24, FColor::Red, false, 2.f);
+			GCDebug::DrawSphere(World, ProjectileEndLocation, 10.f, FColor::Red);
 		}
 
-		SpawnBulletHole(ShotResult);
+		SpawnBulletHole(ShotResult.ImpactPoint, ShotResult.ImpactNormal);
 	}
 
 	if (bDrawDebugEnabled)
 	{
-		DrawDebugLine(World, ProjectileStartLocation, ProjectileEndLocation, FColor::Red, false, 2.f);
+		GCDebug::DrawLine(World, ProjectileStartLocation, ProjectileEndLocation, FColor::Red);
 	}
 
-	UNiagaraComponent* TraceFXComponent = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), TraceFX, ProjectileStartLocation, GetComponentRotation());
-	TraceFXComponent->SetVectorParameter(FXParamTraceEnd, ProjectileEndLocation);
+	SpawnTraceFX(ProjectileStartLocation, ProjectileEndLocation);
+	return bHit;
+}
 
+bool UBarrelComponent::ShootHitScanPenetrating(const FVector& ViewLocation, const FVector& Direction, AController* ShooterController,
+	float ShotTime)
+{
+	GC_TRACE_SCOPE(UBarrelComponent_ShootHitScanPenetrating);
+	const bool bDrawDebugEnabled = GCDebug::IsCategoryEnabled(EGCDebugCategory::RangeWeapons);
+	const UWorld* World = GetWorld();
+	const UGCLagCompensationSubsystem* LagCompensation = World->GetSubsystem<UGCLagCompensationSubsystem>();
+	if (ShotTime < 0.f)
+	{
+		ShotTime = LagCompensation->GetShotTime(ShooterController);
+	}
+	
+	// aim like a single shot: the bullet flies from the muzzle through what the view ray hits and goes on from there
+	const FVector StartLocation = GetComponentLocation();
+	FVector AimLocation = ViewLocation + Range * Direction;
+	FHitResult AimHit;
+	GC_COUNT_TRACES(2);
+	if (LagCompensation->LineTraceRewound(ShotTime, AimHit, ViewLocation, AimLocation, ECC_Bullet, ShotQueryParams.Get(GetOwner()))
+		&& FVector::DotProduct(Direction, AimHit.ImpactPoint - StartLocation) > 0.f)
+	{
+		AimLocation = AimHit.ImpactPoint;
+	}
+	
+	const FVector EndLocation = StartLocation + (AimLocation - StartLocation).GetSafeNormal() * Range;
+	
+	// everything the bullet passes is reported as an overlap, ordered by distance. Only what blocks bullets is walked
+	static const FCollisionResponseParams ResponseParams(ECR_Overlap);
+	LagCompensation->LineTraceMultiRewound(ShotTime, PenetrationHits, StartLocation, EndLocation, ECC_Bullet, PenetratingShotQueryParams.Get(GetOwner()),
+		ResponseParams);
+
+	TArray<const AActor*, TInlineAllocator<8>> DamagedActors;
+	FVector BulletEndLocation = EndLocation;
+	float DamageScale = 1.f;
+	int32 Penetrations = 0;
+	bool bHit = false;
+	for (const FHitResult& Hit : PenetrationHits)
+	{
+		const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+		if (!IsValid(HitComponent) || HitComponent->GetCollisionResponseToChannel(ECC_Bullet) != ECR_Block)
+		{
+			continue;
+		}
+
+		bHit = true;
+		AActor* HitActor = Hit.GetActor();
+		// capsule and mesh of the same character is one hit
+		if (IsValid(HitActor) && !DamagedActors.Contains(HitActor))
+		{
+			DamagedActors.Add(HitActor);
+			ApplyDamageToActor(HitActor, GetDamage(Hit.Distance) * DamageScale, Hit, Direction, ShooterController);
+		}
+
+		SpawnBulletHole(Hit.ImpactPoint, Hit.ImpactNormal);
+		if (bDrawDebugEnabled)
+		{
+			GCDebug::DrawSphere(World, Hit.ImpactPoint, 10.f, FColor::Red);
+		}
+		
+		DamageScale *= PenetrationDamageScales[UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get())];
+		if (DamageScale < PenetrationSettings.MinDamageScale || ++Penetrations > PenetrationSettings.MaxPenetrations)
+		{
+			BulletEndLocation = Hit.ImpactPoint;
+			break;
+		}
+	}
+
+	if (bDrawDebugEnabled)
+	{
+		GCDebug::DrawLine(World, StartLocation, BulletEndLocation, FColor::Red);
+	}
+
+	SpawnTraceFX(StartLocation, BulletEndLocation);
 	return bHit;
 }
 
+#pragma region PELLETS
+
+namespace
+{
+	struct FPelletDamage
+	{
+		AActor* Actor = nullptr;
+		float Damage = 0.f;
+		FHitResult Hit;
+		FVector Direction = FVector::ZeroVector;
+	};
+
+	// pellet hits on the same component facing roughly the same way
+	struct FPelletSurface
+	{
+		const UPrimitiveComponent* Component = nullptr;
+		FVector Normal = FVector::ZeroVector;
+		FVector LocationSum = FVector::ZeroVector;
+		FBox Bounds = FBox(ForceInit);
+		int32 Count = 0;
+	};
+
+	const float SameSurfaceNormalDot = 0.9f;
+	const float MuzzleBlockTolerance = 5.f;
+	// the muzzle obstruction sweep doesn't grow past this, so it doesn't start inside the floor for wide spreads
+	const float MaxObstructionCheckRadius = 30.f;
+}
+
+void UBarrelComponent::ShootPellets(const FVector& ViewLocation, TArrayView<const FVector> Directions, AController* ShooterController,
+	float ShotAge, float ShotTime)
+{
+	GC_TRACE_SCOPE(UBarrelComponent_ShootPellets);
+	// penetrating pellets are traced one by one, each already is a single query
+	if (HitRegistrationType != EHitRegistrationType::HitScan || Directions.Num() == 1 || PenetrationSettings.bEnabled)
+	{
+		for (const FVector& Direction : Directions)
+		{
+			Shoot(ViewLocation, Direction, ShooterController, ShotAge, ShotTime);
+		}
+		
+		return;
+	}
+
+	const bool bDrawDebugEnabled = GCDebug::IsCategoryEnabled(EGCDebugCategory::RangeWeapons);
+	const UWorld* World = GetWorld();
+	const UGCLagCompensationSubsystem* LagCompensation = World->GetSubsystem<UGCLagCompensationSubsystem>();
+	if (ShotTime < 0.f)
+	{
+		ShotTime = LagCompensation->GetShotTime(ShooterController);
+	}
+	
+	const FCollisionQueryParams& CollisionQueryParams = ShotQueryParams.Get(GetOwner());
+	const FVector MuzzleLocation = GetComponentLocation();
+
+	// 1. view traces of all pellets as one batch on task threads
+	const int32 PelletsCount = Directions.Num();
+	TArray<FHitResult, TInlineAllocator<16>> PelletHits;
+	TArray<FVector, TInlineAllocator<16>> PelletEnds;
+	PelletHits.SetNum(PelletsCount);
+	PelletEnds.SetNum(PelletsCount);
+	GC_COUNT_TRACES(PelletsCount);
+	ParallelFor(PelletsCount, [&](int32 i)
+	{
+		const FVector TraceEnd = ViewLocation + Range * Directions[i];
+		const bool bHit = LagCompensation->LineTraceRewound(ShotTime, PelletHits[i], ViewLocation, TraceEnd, ECC_Bullet, CollisionQueryParams);
+		PelletEnds[i] = bHit ? PelletHits[i].ImpactPoint : TraceEnd;
+	});
+
+	// 2. pellets go from the muzzle, not the view. One sweep around the pellets' axis tells if anything sits between the muzzle
+	// and the pellet ends; only then, and for pellets that hit something behind the muzzle, pellets are retraced from the muzzle
+	TArray<int32, TInlineAllocator<16>> MuzzleRetraces;
+	FVector Axis = FVector::ZeroVector;
+	float NearestEndDistance = Range;
+	for (int32 i = 0; i < PelletsCount; ++i)
+	{
+		if (FVector::DotProduct(Directions[i], PelletEnds[i] - MuzzleLocation) <= 0.f)
+		{
+			MuzzleRetraces.Add(i);
+			continue;
+		}
+
+		Axis += Directions[i].GetSafeNormal();
+		NearestEndDistance = FMath::Min(NearestEndDistance, FVector::Dist(MuzzleLocation, PelletEnds[i]));
+	}
+
+	const int32 BehindMuzzleCount = MuzzleRetraces.Num();
+	const float ObstructionCheckDistance = NearestEndDistance - MuzzleBlockTolerance;
+	if (BehindMuzzleCount < PelletsCount && ObstructionCheckDistance > 0.f)
+	{
+		Axis.Normalize();
+		float ConeRadius = 0.f;
+		for (const FVector& Direction : Directions)
+		{
+			ConeRadius = FMath::Max(ConeRadius, FVector::Dist(Direction.GetSafeNormal(), Axis) * ObstructionCheckDistance);
+		}
+
+		FHitResult ObstructionHit;
+		GC_COUNT_TRACES(1);
+		const FCollisionShape ObstructionShape = FCollisionShape::MakeSphere(FMath::Min(ConeRadius, MaxObstructionCheckRadius));
+		if (World->SweepSingleByChannel(ObstructionHit, MuzzleLocation, MuzzleLocation + Axis * ObstructionCheckDistance, FQuat::Identity,
+			ECC_Bullet, ObstructionShape, CollisionQueryParams))
+		{
+			for (int32 i = 0; i < PelletsCount; ++i)
+			{
+				if (!MuzzleRetraces.Contains(i))
+				{
+					MuzzleRetraces.Add(i);
+				}
+			}
+		}
+	}
+
+	GC_COUNT_TRACES(MuzzleRetraces.Num());
+	ParallelFor(MuzzleRetraces.Num(), [&](int32 RetraceIndex)
+	{
+		const int32 i = MuzzleRetraces[RetraceIndex];
+		if (RetraceIndex < BehindMuzzleCount)
+		{
+			// hit something between the camera and the muzzle, the muzzle trace is the only one that counts
+			const FVector TraceEnd = ViewLocation + Range * Directions[i];
+			const bool bHit = LagCompensation->LineTraceRewound(ShotTime, PelletHits[i], MuzzleLocation, TraceEnd, ECC_Bullet, CollisionQueryParams);
+			PelletEnds[i] = bHit ? PelletHits[i].ImpactPoint : TraceEnd;
+			return;
+		}
+
+		FHitResult MuzzleHit;
+		if (LagCompensation->LineTraceRewound(ShotTime, MuzzleHit, MuzzleLocation, PelletEnds[i], ECC_Bullet, CollisionQueryParams)
+			&& FVector::Dist(MuzzleLocation, MuzzleHit.ImpactPoint) < FVector::Dist(MuzzleLocation, PelletEnds[i]) - MuzzleBlockTolerance)
+		{
+			PelletHits[i] = MuzzleHit;
+			PelletEnds[i] = MuzzleHit.ImpactPoint;
+		}
+	});
+
+	// 3. aggregate damage per actor and impacts per surface
+	TArray<FPelletDamage, TInlineAllocator<4>> PelletDamages;
+	TArray<FPelletSurface, TInlineAllocator<4>> PelletSurfaces;
+	FVector MissEndSum = FVector::ZeroVector;
+	int32 MissCount = 0;
+	for (int32 i = 0; i < Directions.Num(); ++i)
+	{
+		const FHitResult& PelletHit = PelletHits[i];
+		if (bDrawDebugEnabled)
+		{
+			GCDebug::DrawLine(World, MuzzleLocation, PelletEnds[i], FColor::Red);
+		}
+		
+		if (!PelletHit.bBlockingHit)
+		{
+			MissEndSum += PelletEnds[i];
+			MissCount++;
+			continue;
+		}
+
+		if (bDrawDebugEnabled)
+		{
+			GCDebug::DrawSphere(World, PelletHit.ImpactPoint, 10.f, FColor::Red);
+		}
+		
+		AActor* HitActor = PelletHit.GetActor();
+		if (IsValid(HitActor))
+		{
+			FPelletDamage* PelletDamage = PelletDamages.FindByPredicate([HitActor](const FPelletDamage& Entry) { return Entry.Actor == HitActor; });
+			if (PelletDamage == nullptr)
+			{
+				PelletDamage = &PelletDamages.AddDefaulted_GetRef();
+				PelletDamage->Actor = HitActor;
+				PelletDamage->Hit = PelletHit;
+				PelletDamage->Direction = Directions[i];
+			}
+
+			PelletDamage->Damage += GetDamage(FVector::Dist(MuzzleLocation, PelletHit.ImpactPoint));
+		}
+
+		const UPrimitiveComponent* HitComponent = PelletHit.GetComponent();
+		FPelletSurface* Surface = PelletSurfaces.FindByPredicate([HitComponent, &PelletHit](const FPelletSurface& Entry)
+		{
+			return Entry.Component == HitComponent && FVector::DotProduct(Entry.Normal, PelletHit.ImpactNormal) > SameSurfaceNormalDot;
+		});
+		
+		if (Surface == nullptr)
+		{
+			Surface = &PelletSurfaces.AddDefaulted_GetRef();
+			Surface->Component = HitComponent;
+			Surface->Normal = PelletHit.ImpactNormal;
+		}
+
+		Surface->LocationSum += PelletHit.ImpactPoint;
+		Surface->Bounds += PelletHit.ImpactPoint;
+		Surface->Count++;
+	}
+
+	for (const FPelletDamage& PelletDamage : PelletDamages)
+	{
+		if (IsValid(PelletDamage.Actor))
+		{
+			ApplyDamageToActor(PelletDamage.Actor, PelletDamage.Damage, PelletDamage.Hit, PelletDamage.Direction.GetSafeNormal(), ShooterController);
+		}
+	}
+
+	for (const FPelletSurface& Surface : PelletSurfaces)
+	{
+		const FVector SurfaceCenter = Surface.LocationSum / Surface.Count;
+		const float SpreadRadius = Surface.Count > 1 ? Surface.Bounds.GetExtent().Size() : 0.f;
+		SpawnBulletHole(SurfaceCenter, Surface.Normal, FMath::Clamp(1.f + SpreadRadius / FMath::Max(DecalSettings.Size.Y, 1.f), 1.f, MaxPelletDecalScale));
+		SpawnTraceFX(MuzzleLocation, SurfaceCenter);
+	}
+
+	if (MissCount > 0)
+	{
+		SpawnTraceFX(MuzzleLocation, MissEndSum / MissCount);
+	}
+}
+
+#pragma endregion PELLETS
+
 bool UBarrelComponent::ShootProjectile(const FVector& ViewLocation, const FVector& ViewDirection,
-	AController* ShooterController)
+	AController* ShooterController, float ShotAge)
 {
+	GC_LLM_SCOPE(Projectiles);
 	CachedShooterController = ShooterController;
 	FVector ShootDirection = (ViewLocation + ViewDirection * Range) - GetComponentLocation();
-	AGCProjectile* CurrentProjectile = GetWorld()->SpawnActor<AGCProjectile>(ProjectileClass, GetComponentLocation(), FRotator::ZeroRotator);
-	CurrentProjectile->SetOwner(GetOwner());
+	UGCProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UGCProjectilePoolSubsystem>();
+	AGCProjectile* CurrentProjectile = ProjectilePool->AcquireProjectile(ProjectileClass, FTransform(GetComponentLocation()), GetOwner());
 	FHitResult TraceResult;
 	const FVector TraceEnd = ViewLocation + ShootDirection * Range;
+	GC_COUNT_TRACES(1);
 	bool bHit = GetWorld()->LineTraceSingleByChannel(TraceResult, ViewLocation, TraceEnd, ECC_Visibility);
 	ShootDirection = bHit || TraceResult.bBlockingHit
 		? (TraceResult.ImpactPoint - CurrentProjectile->GetActorLocation()).GetSafeNormal()
@@ -90,73 +452,152 @@ bool UBarrelComponent::ShootProjectile(const FVector& ViewLocation, const FVecto
 	CurrentProjectile->SetActorRotation(ShootDirection.ToOrientationRotator());
 	CurrentProjectile->ProjectileHitEvent.BindUObject(this, &UBarrelComponent::OnProjectileHit);
 	
-	CurrentProjectile->LaunchProjectile(ShootDirection.GetSafeNormal(), GetOwner()->GetVelocity().Size() + ProjectileSpeed, ShooterController);
+	const float LaunchSpeed = GetOwner()->GetVelocity().Size() + ProjectileSpeed;
+	CurrentProjectile->LaunchProjectile(ShootDirection.GetSafeNormal(), LaunchSpeed, ShooterController);
+	if (ShotAge > 0.f)
+	{
+		// swept, so a hit on the way is still reported
+		CurrentProjectile->AddActorWorldOffset(ShootDirection * LaunchSpeed * ShotAge, true);
+	}
+	
 	return true;
 }
 
+void UBarrelComponent::ShootSimulatedProjectile(const FVector& ViewLocation, const FVector& ViewDirection,
+	AController* ShooterController, float ShotAge)
+{
+	// no view trace here, simulated rounds are meant for high fire rates. Aim at the end of the view ray instead
+	CachedShooterController = ShooterController;
+	const FVector MuzzleLocation = GetComponentLocation();
+	const FVector ShootDirection = (ViewLocation + ViewDirection * Range - MuzzleLocation).GetSafeNormal();
+	const FVector Velocity = ShootDirection * ProjectileSpeed + GetOwner()->GetVelocity();
+	UGCProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UGCProjectileSimulationSubsystem>();
+	ProjectileSimulation->AddProjectile(MuzzleLocation, Velocity, SimulatedProjectileGravityScale, SimulatedProjectileRadius, Range,
+		this, GetOwner(), ShotAge);
+}
+
 void UBarrelComponent::OnProjectileHit(const FHitResult& HitResult, const FVector& Direction)
 {
+	GC_TRACE_SCOPE(UBarrelComponent_OnProjectileHit);
 	if (CachedShooterController.IsValid())
 	{
 		ApplyDamage(HitResult, Direction, CachedShooterController.Get());
 	}
 	
-	SpawnBulletHole(HitResult);
+	SpawnBulletHole(HitResult.ImpactPoint, HitResult.ImpactNormal);
+}
+
+bool UBarrelComponent::GetProjectileBallistics(float& OutSpeed, float& OutGravityScale) const
+{
+	switch (HitRegistrationType)
+	{
+		case EHitRegistrationType::Projectile:
+			OutSpeed = ProjectileSpeed;
+			OutGravityScale = IsValid(ProjectileClass) ? ProjectileClass.GetDefaultObject()->GetGravityScale() : 1.f;
+			return true;
+		case EHitRegistrationType::SimulatedProjectile:
+			OutSpeed = ProjectileSpeed;
+			OutGravityScale = SimulatedProjectileGravityScale;
+			return true;
+		default:
+			return false;
+	}
 }
 
 void UBarrelComponent::ApplyDamage(const FHitResult& ShotResult, const FVector& Direction, AController* ShooterController) const
 {
 	AActor* HitActor = ShotResult.GetActor();
-	// Perhaps its better to use squared distance
-	float Damage = IsValid(DamageFalloffDiagram)
-		? DamageFalloffDiagram->GetFloatValue(ShotResult.Distance / Range) * InitialDamage
-		: InitialDamage;
-		
 	if (IsValid(HitActor))
 	{
-		FPointDamageEvent DamageEvent;
-		DamageEvent.HitInfo = ShotResult;
-		DamageEvent.ShotDirection = Direction;
-		DamageEvent.DamageTypeClass = DamageTypeClass;
-		HitActor->TakeDamage(Damage, DamageEvent, ShooterController, GetDamagingActor());	
+		ApplyDamageToActor(HitActor, GetDamage(ShotResult.Distance), ShotResult, Direction, ShooterController);
 	}
 }
 
-void UBarrelComponent::SpawnBulletHole(const FHitResult& HitResult)
+void UBarrelComponent::ApplyDamageToActor(AActor* HitActor, float Damage, const FHitResult& ShotResult, const FVector& Direction,
+	AController* ShooterController) const
 {
-	UDecalComponent* DecalComponent = UGameplayStatics::SpawnDecalAtLocation(GetWorld(), DecalSettings.Material, DecalSettings.Size, HitResult.ImpactPoint,
-																			HitResult.ImpactNormal.ToOrientationRotator());
-	if (IsValid(DecalComponent))
-	{
-		DecalComponent->SetFadeOut(DecalSettings.LifeTime, DecalSettings.FadeOutTime);
-		DecalComponent->SetFadeScreenSize(0.0001f);
-	}
+	FPointDamageEvent DamageEvent;
+	DamageEvent.HitInfo = ShotResult;
+	DamageEvent.ShotDirection = Direction;
+	DamageEvent.DamageTypeClass = DamageTypeClass;
+	HitActor->TakeDamage(Damage, DamageEvent, ShooterController, GetDamagingActor());
+}
+
+float UBarrelComponent::GetDamage(float Distance) const
+{
+	// Perhaps its better to use squared distance
+	return IsValid(DamageFalloffDiagram)
+		? DamageFalloffDiagram->GetFloatValue(Distance / Range) * InitialDamage
+		: InitialDamage;
+}
+
+void UBarrelComponent::SpawnBulletHole(const FVector& Location, const FVector& Normal, float SizeScale)
+{
+	const FVector DecalSize(DecalSettings.Size.X, DecalSettings.Size.Y * SizeScale, DecalSettings.Size.Z * SizeScale);
+	GetWorld()->GetSubsystem<UGCDecalSubsystem>()->SpawnDecal(DecalSettings, Location, Normal.ToOrientationRotator(), DecalSize);
 }
 
-void UBarrelComponent::FinalizeShot() const
+void UBarrelComponent::SpawnTraceFX(const FVector& Start, const FVector& End)
 {
-	if (IsValid(MuzzleFlashFX))
+	GC_LLM_SCOPE(FX);
+	if (IsValid(PersistentTracerFX))
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), MuzzleFlashFX, GetComponentLocation(), GetComponentRotation());
+		PendingTracerStarts.Add(Start);
+		PendingTracerEnds.Add(End);
+		SetComponentTickEnabled(true);
+		return;
 	}
 	
-	if (IsValid(ShotSound))
+	UNiagaraComponent* TraceFXComponent = GetWorld()->GetSubsystem<UGCFXSubsystem>()->SpawnNiagaraAtLocation(TraceFX, Start, GetComponentRotation());
+	if (IsValid(TraceFXComponent))
 	{
-		UGameplayStatics::SpawnSoundAttached(ShotSound, GetAttachmentRoot());
+		TraceFXComponent->SetVectorParameter(FXParamTraceEnd, End);
 	}
 }
 
-#if UE_BUILD_DEVELOPMENT || UE_BUILD_DEBUG
-
-const UGCDebugSubsystem* UBarrelComponent::GetDebugSubsystem() const
+void UBarrelComponent::FlushTracers()
 {
-	if (!IsValid(DebugSubsystem))
+	GC_TRACE_SCOPE(UBarrelComponent_FlushTracers);
+	if (PendingTracerStarts.Num() == 0)
 	{
-		DebugSubsystem = UGameplayStatics::GetGameInstance(GetWorld())->GetSubsystem<UGCDebugSubsystem>();
+		// tracers were emitted last frame, stop emitting them
+		if (bTracerCountDirty && IsValid(PersistentTracerComponent))
+		{
+			PersistentTracerComponent->SetIntParameter(FXParamTracerCount, 0);
+		}
+		
+		bTracerCountDirty = false;
+		SetComponentTickEnabled(false);
+		return;
 	}
 
-	return DebugSubsystem;
+	if (!IsValid(PersistentTracerComponent))
+	{
+		GC_LLM_SCOPE(FX);
+		PersistentTracerComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(PersistentTracerFX, this, NAME_None, FVector::ZeroVector,
+			FRotator::ZeroRotator, EAttachLocation::KeepRelativeOffset, false);
+		if (!IsValid(PersistentTracerComponent))
+		{
+			PendingTracerStarts.Reset();
+			PendingTracerEnds.Reset();
+			return;
+		}
+	}
+
+	UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(PersistentTracerComponent, FXParamTracerStarts, PendingTracerStarts);
+	UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(PersistentTracerComponent, FXParamTracerEnds, PendingTracerEnds);
+	PersistentTracerComponent->SetIntParameter(FXParamTracerCount, PendingTracerStarts.Num());
+	bTracerCountDirty = true;
+	PendingTracerStarts.Reset();
+	PendingTracerEnds.Reset();
 }
 
-#endif	
+void UBarrelComponent::FinalizeShot()
+{
+	GC_TRACE_SCOPE(UBarrelComponent_FinalizeShot);
+	UGCFXSubsystem* FXSubsystem = GetWorld()->GetSubsystem<UGCFXSubsystem>();
+	FXSubsystem->SpawnNiagaraAtLocation(MuzzleFlashFX, GetComponentLocation(), GetComponentRotation());
+	FXSubsystem->PlaySoundPooled(ShotSoundEmitter, ShotSound, GetAttachmentRoot(), MaxShotSoundVoices, ShotSoundConcurrency);
+}
+	
 
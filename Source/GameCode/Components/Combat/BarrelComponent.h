@@ -1,18 +1,23 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GCDebugSubsystem.h"
 #include "Components/SceneComponent.h"
 #include "Data/DecalSettings.h"
+#include "Data/PenetrationSettings.h"
+#include "Subsystems/GCFXSubsystem.h"
+#include "Utils/GCTraceUtils.h"
 #include "BarrelComponent.generated.h"
 
+class UNiagaraComponent;
 class UNiagaraSystem;
 
 UENUM(BlueprintType)
 enum class EHitRegistrationType : uint8
 {
 	HitScan,
-	Projectile
+	Projectile,
+	// no actor is spawned, see UGCProjectileSimulationSubsystem
+	SimulatedProjectile
 };
 
 UCLASS( ClassGroup=(Custom), Abstract )
@@ -21,9 +26,23 @@ class GAMECODE_API UBarrelComponent : public USceneComponent
 	GENERATED_BODY()
 
 public:
-	virtual void Shoot(const FVector& ViewLocation, const FVector& Direction, AController* ShooterController);
+	UBarrelComponent();
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	
+	// ShotAge - how long ago in this frame the shot was due. Projectiles are moved ahead by it, so rounds fired in one frame
+	// by a fast firing weapon don't bunch up. ShotTime - world time hitscan is traced at, negative means the shooter's ping is used
+	virtual void Shoot(const FVector& ViewLocation, const FVector& Direction, AController* ShooterController, float ShotAge = 0.f,
+		float ShotTime = -1.f);
+	// All bullets of a single shot (shotgun pellets). Hitscan pellets are traced from the view as one parallel batch and retraced
+	// from the muzzle only when a single sweep finds the muzzle obstructed. Damage is summed per hit actor and impact fx are
+	// spawned once per hit surface
+	void ShootPellets(const FVector& ViewLocation, TArrayView<const FVector> Directions, AController* ShooterController, float ShotAge = 0.f,
+		float ShotTime = -1.f);
 	virtual void ApplyDamage(const FHitResult& ShotResult, const FVector& Direction, AController* ShooterController) const;
-	virtual void FinalizeShot() const;
+	virtual void FinalizeShot();
+
+	// False for hitscan
+	bool GetProjectileBallistics(float& OutSpeed, float& OutGravityScale) const;
 
 	int32 GetAmmo() const { return Ammo; }
 	void SetAmmo(int32 NewValue) { Ammo = NewValue; }
@@ -42,11 +61,28 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	UNiagaraSystem* TraceFX;
 
+	// One tracer system per barrel instead of TraceFX per bullet. Gets all segments shot during a frame in TracerStarts/TracerEnds
+	// vector arrays and TracerCount int, which is reset to 0 on the next frame
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	UNiagaraSystem* PersistentTracerFX;
+
+	// Muzzle flash and trace fx components put into the niagara pool on begin play
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin=0, UIMin = 0))
+	int32 FXPoolPrewarmCount = 0;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	FDecalSettings DecalSettings; 
 
+	// Pellets hitting the same surface share one decal, scaled up to cover the spread but no more than this
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(ClampMin = 1.f, UIMin = 1.f))
+	float MaxPelletDecalScale = 3.f;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	EHitRegistrationType HitRegistrationType = EHitRegistrationType::HitScan;
+
+	// One multi hit trace per bullet instead of a single hit trace, walking through penetrable surfaces
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (EditCondition = "HitRegistrationType == EHitRegistrationType::HitScan"))
+	FPenetrationSettings PenetrationSettings;
 	
 	// MUst be normalized 0..1 on both axis. Curve value will be multiplied by InitialDamage and applied to actor
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
@@ -58,26 +94,67 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (EditCondition = "HitRegistrationType == EHitRegistrationType::Projectile"))
 	TSubclassOf<class AGCProjectile> ProjectileClass;
 	
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin=200.f, UIMin = 200.f, EditCondition = "HitRegistrationType == EHitRegistrationType::Projectile"))
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin=200.f, UIMin = 200.f, EditCondition = "HitRegistrationType != EHitRegistrationType::HitScan"))
 	float ProjectileSpeed = 2000.f;
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin=0.f, UIMin = 0.f, EditCondition = "HitRegistrationType == EHitRegistrationType::SimulatedProjectile"))
+	float SimulatedProjectileGravityScale = 1.f;
+
+	// 0 means line trace instead of sphere sweep
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin=0.f, UIMin = 0.f, EditCondition = "HitRegistrationType == EHitRegistrationType::SimulatedProjectile"))
+	float SimulatedProjectileRadius = 0.f;
+
+	// Projectiles spawned into the pool on begin play, so the first bursts don't spawn actors
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin=0, UIMin = 0, EditCondition = "HitRegistrationType == EHitRegistrationType::Projectile"))
+	int32 ProjectilePoolPrewarmCount = 0;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	class USoundCue* ShotSound;
 
+	// Shot sounds of this barrel overlapping at once. Shots beyond that restart the oldest sound instead of spawning audio components
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin=1, UIMin = 1))
+	int32 MaxShotSoundVoices = 2;
+
+	// Limits shared by all barrels with this concurrency, e.g. max shot sounds in the world
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	class USoundConcurrency* ShotSoundConcurrency;
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual AActor* GetDamagingActor() const { return GetOwner(); }
 	
 private:
-
-	bool ShootHitScan(const FVector& ViewLocation, const FVector& Direction, AController* ShooterController);
-	bool ShootProjectile(const FVector& ViewLocation, const FVector& ViewDirection, AController* ShooterController);
-	void SpawnBulletHole(const FHitResult& HitResult);
+	friend class UGCProjectileSimulationSubsystem;
+
+	bool ShootHitScan(const FVector& ViewLocation, const FVector& Direction, AController* ShooterController, float ShotTime);
+	bool ShootHitScanPenetrating(const FVector& ViewLocation, const FVector& Direction, AController* ShooterController, float ShotTime);
+	bool ShootProjectile(const FVector& ViewLocation, const FVector& ViewDirection, AController* ShooterController, float ShotAge);
+	void ShootSimulatedProjectile(const FVector& ViewLocation, const FVector& ViewDirection, AController* ShooterController, float ShotAge);
+	void SpawnBulletHole(const FVector& Location, const FVector& Normal, float SizeScale = 1.f);
+	void SpawnTraceFX(const FVector& Start, const FVector& End);
+	float GetDamage(float Distance) const;
+	void ApplyDamageToActor(AActor* HitActor, float Damage, const FHitResult& ShotResult, const FVector& Direction, AController* ShooterController) const;
 	void OnProjectileHit(const FHitResult& HitResult, const FVector& Direction);
 	TWeakObjectPtr<AController> CachedShooterController = nullptr;
+	GCTraceUtils::FOwnerChainQueryParams ShotQueryParams = GCTraceUtils::FOwnerChainQueryParams(FName("BarrelShot"));
+	GCTraceUtils::FOwnerChainQueryParams PenetratingShotQueryParams = GCTraceUtils::FOwnerChainQueryParams(FName("BarrelPenetratingShot"), false, true);
+
+	// PenetrationSettings.Surfaces baked into damage scale per EPhysicalSurface
+	TArray<float> PenetrationDamageScales;
+	// reused by penetrating traces
+	TArray<FHitResult> PenetrationHits;
 
 	int32 Ammo = 0;
+
+	UPROPERTY(Transient)
+	UNiagaraComponent* PersistentTracerComponent;
+
+	UPROPERTY(Transient)
+	FPooledSoundEmitter ShotSoundEmitter;
+	
+	TArray<FVector> PendingTracerStarts;
+	TArray<FVector> PendingTracerEnds;
+	bool bTracerCountDirty = false;
 	
-	#if UE_BUILD_DEVELOPMENT || UE_BUILD_DEBUG
-	const UGCDebugSubsystem* GetDebugSubsystem() const;
-	mutable UGCDebugSubsystem* DebugSubsystem;
-	#endif
+	void FlushTracers();
 };
@@ -1,26 +1,28 @@
 #include "ExplosionComponent.h"
 
-#include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystem.h"
 #include "Sound/SoundCue.h"
+#include "GameCode.h"
+#include "Subsystems/GCRadialDamageSubsystem.h"
+#include "Subsystems/GCTrajectoryPredictionSubsystem.h"
 
 void UExplosionComponent::Explode(AController* Controller)
 {
-	TArray<AActor*> IgnoredActors;
-	IgnoredActors.Add(GetOwner());
-	// ECC_Visibility is kinda lame here
-	UGameplayStatics::ApplyRadialDamageWithFalloff(GetWorld(), MaxDamage, MinDamage, GetComponentLocation(),
-		InnerRadius, OuterRadius, DamageFalloff, DamageTypeClass, IgnoredActors, GetOwner(), Controller, ECC_Visibility);	
-	
-	if (IsValid(ExplosionVFX))
-	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionVFX, GetComponentLocation());
-	}
-	
-	if (IsValid(ExplosionSFX))
-	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), ExplosionSFX, GetComponentLocation());
-	}
+	GC_TRACE_SCOPE(UExplosionComponent_Explode);
+	// damage and fx are resolved at the end of the frame together with other explosions
+	FQueuedExplosion Explosion;
+	Explosion.Params = FRadialDamageParams(MaxDamage, MinDamage, InnerRadius, OuterRadius, DamageFalloff);
+	Explosion.Origin = GetComponentLocation();
+	Explosion.DamageTypeClass = DamageTypeClass;
+	Explosion.DamageCauser = GetOwner();
+	Explosion.InstigatedByController = Controller;
+	Explosion.OcclusionChannel = OcclusionChannel;
+	Explosion.NiagaraFX = ExplosionNiagaraFX;
+	Explosion.CascadeFX = IsValid(ExplosionNiagaraFX) ? nullptr : ExplosionVFX;
+	Explosion.Sound = ExplosionSFX;
+	GetWorld()->GetSubsystem<UGCRadialDamageSubsystem>()->QueueExplosion(Explosion);
+	// whatever the explosion pushed around may now be in the way of predicted throws
+	GetWorld()->GetSubsystem<UGCTrajectoryPredictionSubsystem>()->NotifyGeometryChanged(FBox::BuildAABB(GetComponentLocation(), FVector(OuterRadius)));
 	
 	if (ExplosionEvent.IsBound())
 	{
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GameCode.h"
 #include "Components/SceneComponent.h"
 #include "ExplosionComponent.generated.h"
 
@@ -36,9 +37,17 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(UIMin = 0, ClampMin = 0))
 	float OuterRadius = 2000.f;
 
+	// Only blocking hits on this channel shield from the explosion. ExplosionOcclusion is ignored by pawns and ragdolls
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TEnumAsByte<ECollisionChannel> OcclusionChannel = ECC_ExplosionOcclusion;
+
+	// Legacy cascade fx, used only when ExplosionNiagaraFX is not set
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	UParticleSystem* ExplosionVFX;
 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	class UNiagaraSystem* ExplosionNiagaraFX;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	class USoundCue* ExplosionSFX;
 	
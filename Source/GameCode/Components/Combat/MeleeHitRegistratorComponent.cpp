@@ -1,57 +1,132 @@
 #include "MeleeHitRegistratorComponent.h"
 
-#include "GameCode.h"
-#include "GCDebugSubsystem.h"
-#include "DrawDebugHelpers.h"
-#include "Utils/DebugUtils.h"
-#include "Utils/GCTraceUtils.h"
+#include "Animation/AnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
 
 UMeleeHitRegistratorComponent::UMeleeHitRegistratorComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bCanEverTick = false;
 	SphereRadius = 5.f;
 	SetCollisionProfileName(ProfileNoCollision);
 }
 
-void UMeleeHitRegistratorComponent::TickComponent(float DeltaTime, ELevelTick Tick,
-	FActorComponentTickFunction* ThisTickFunction)
+void UMeleeHitRegistratorComponent::SetIsEnabled(bool bNewValue)
 {
-	Super::TickComponent(DeltaTime, Tick, ThisTickFunction);
-	if (bEnabled)
+	if (bNewValue && !bEnabled)
 	{
-		ProcessHitRegistration();
+		// the first path starts where the registrator is now, not where it was when hit registration was last on
+		CachePreviousState();
 	}
-	// order is important
-	PreviousLocation = GetComponentLocation();
+	
+	bEnabled = bNewValue;
 }
 
-void UMeleeHitRegistratorComponent::ProcessHitRegistration()
+void UMeleeHitRegistratorComponent::GetSweepPoints(float DeltaTime, TArray<FVector, TInlineAllocator<8>>& OutPoints)
 {
-	#if ENABLE_DRAW_DEBUG
-		bool bDrawDebugEnabled = GetDebugSubsystem(GetWorld())->IsDebugCategoryEnabled(DebugCategoryMeleeWeapons);
-	#else
-		bool bDrawDebugEnabled = false;
-	#endif
+	const FVector CurrentLocation = GetComponentLocation();
+	OutPoints.Reset();
+	OutPoints.Add(PreviousLocation);
+	if (bPoseSubstepping)
+	{
+		AddSubstepPoints(DeltaTime, CurrentLocation, OutPoints);
+	}
+	
+	OutPoints.Add(CurrentLocation);
+}
 
+USkeletalMeshComponent* UMeleeHitRegistratorComponent::GetAttachMesh(FName& OutBoneName) const
+{
+	// weapon is attached to a socket of the character mesh
+	const USceneComponent* WeaponRoot = GetOwner()->GetRootComponent();
+	USkeletalMeshComponent* Mesh = IsValid(WeaponRoot) ? Cast<USkeletalMeshComponent>(WeaponRoot->GetAttachParent()) : nullptr;
+	if (IsValid(Mesh))
+	{
+		OutBoneName = Mesh->GetSocketBoneName(WeaponRoot->GetAttachSocketName());
+	}
 	
-	FVector CurrentLocation = GetComponentLocation();
-	FCollisionQueryParams QueryParams;
-	AActor* Owner = GetOwner();
-	while (Owner != nullptr)
+	return Mesh;
+}
+
+void UMeleeHitRegistratorComponent::AddSubstepPoints(float DeltaTime, const FVector& CurrentLocation,
+	TArray<FVector, TInlineAllocator<8>>& OutPoints)
+{
+	const int32 Substeps = FMath::Min(FMath::CeilToInt(DeltaTime * SubstepRate), MaxSubsteps);
+	if (Substeps <= 1)
+	{
+		return;
+	}
+
+	FName BoneName = NAME_None;
+	const USkeletalMeshComponent* Mesh = GetAttachMesh(BoneName);
+	const UAnimInstance* AnimInstance = IsValid(Mesh) ? Mesh->GetAnimInstance() : nullptr;
+	const UAnimMontage* Montage = IsValid(AnimInstance) ? AnimInstance->GetCurrentActiveMontage() : nullptr;
+	// new montage or a jump back - nothing to interpolate between
+	if (!IsValid(Montage) || Montage != PreviousMontage.Get())
+	{
+		return;
+	}
+
+	const float CurrentMontagePosition = AnimInstance->Montage_GetPosition(Montage);
+	if (CurrentMontagePosition <= PreviousMontagePosition)
 	{
-		QueryParams.AddIgnoredActor(Owner);
-		Owner = Owner->GetOwner();
+		return;
 	}
 
-	GCTraceUtils::FTraceParams TraceParams(bDrawDebugEnabled);
-	FHitResult Hit;
-	// TODO SweepSphereMultiByChannel?
-	bool bHit = GCTraceUtils::SweepSphereSingleByChannel(GetWorld(), Hit, PreviousLocation, CurrentLocation, GetScaledSphereRadius(),
-		ECC_MeleeHitRegistrator, QueryParams, TraceParams);
+	if (!BoneSampler.IsInitializedFor(Mesh, BoneName) && !BoneSampler.Initialize(Mesh, BoneName))
+	{
+		return;
+	}
+
+	// the registrator is rigid relative to the bone
+	const FTransform& MeshTransform = Mesh->GetComponentTransform();
+	const FVector LocationInBone = Mesh->GetSocketTransform(BoneName).InverseTransformPosition(CurrentLocation);
+
+	// the sampled pose is only the montage, while the actual one has blends and IK on top. The difference at both ends is
+	// distributed along the substeps so the path starts and ends exactly at the actual locations
+	FTransform PreviousBoneTransform;
+	FTransform CurrentBoneTransform;
+	if (!BoneSampler.Sample(Montage, PreviousMontagePosition, PreviousBoneTransform)
+		|| !BoneSampler.Sample(Montage, CurrentMontagePosition, CurrentBoneTransform))
+	{
+		return;
+	}
+
+	const FVector PreviousError = PreviousLocation - (PreviousBoneTransform * PreviousMeshTransform).TransformPosition(LocationInBone);
+	const FVector CurrentError = CurrentLocation - (CurrentBoneTransform * MeshTransform).TransformPosition(LocationInBone);
+	FTransform BoneTransform;
+	FTransform SubstepMeshTransform;
+	for (int32 i = 1; i < Substeps; ++i)
+	{
+		const float Alpha = (float)i / Substeps;
+		if (!BoneSampler.Sample(Montage, FMath::Lerp(PreviousMontagePosition, CurrentMontagePosition, Alpha), BoneTransform))
+		{
+			return;
+		}
+
+		SubstepMeshTransform.Blend(PreviousMeshTransform, MeshTransform, Alpha);
+		const FVector SampledLocation = (BoneTransform * SubstepMeshTransform).TransformPosition(LocationInBone);
+		OutPoints.Add(SampledLocation + FMath::Lerp(PreviousError, CurrentError, Alpha));
+	}
+}
 
-	if (bHit)
+void UMeleeHitRegistratorComponent::CachePreviousState()
+{
+	PreviousLocation = GetComponentLocation();
+	if (!bPoseSubstepping)
 	{
-		FVector Direction = (CurrentLocation - PreviousLocation).GetSafeNormal();
-		MeleeHitRegisteredEvent.ExecuteIfBound(Hit, Direction);
+		return;
 	}
-}
\ No newline at end of file
+
+	FName BoneName = NAME_None;
+	const USkeletalMeshComponent* Mesh = GetAttachMesh(BoneName);
+	const UAnimInstance* AnimInstance = IsValid(Mesh) ? Mesh->GetAnimInstance() : nullptr;
+	if (!IsValid(AnimInstance))
+	{
+		PreviousMontage.Reset();
+		return;
+	}
+
+	PreviousMeshTransform = Mesh->GetComponentTransform();
+	PreviousMontage = AnimInstance->GetCurrentActiveMontage();
+	PreviousMontagePosition = PreviousMontage.IsValid() ? AnimInstance->Montage_GetPosition(PreviousMontage.Get()) : 0.f;
+}
@@ -2,10 +2,12 @@
 
 #include "CoreMinimal.h"
 #include "Components/SphereComponent.h"
+#include "Utils/GCAnimUtils.h"
 #include "MeleeHitRegistratorComponent.generated.h"
 
-DECLARE_DELEGATE_TwoParams(FMeleeHitRegisteredEvent, const FHitResult& Hit, const FVector& HitDirection);
+class UAnimMontage;
 
+// Registrators don't tick on their own: the owning melee weapon sweeps the paths of all its registrators while hit registration is on
 UCLASS(meta=(BlueprintSpawnableComponent))
 class GAMECODE_API UMeleeHitRegistratorComponent : public USphereComponent
 {
@@ -14,18 +16,42 @@ class GAMECODE_API UMeleeHitRegistratorComponent : public USphereComponent
 public:
 	UMeleeHitRegistratorComponent();
 
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// Path of the registrator since the previous frame, starting at the previous location and ending at the current one.
+	// Just these 2 points unless pose substepping is on
+	void GetSweepPoints(float DeltaTime, TArray<FVector, TInlineAllocator<8>>& OutPoints);
 
-	void ProcessHitRegistration();
+	// Call after the sweep, the current state becomes the start of the next path
+	void CachePreviousState();
 
-	void SetIsEnabled(bool bNewValue) { bEnabled = bNewValue; }
-
-	mutable FMeleeHitRegisteredEvent MeleeHitRegisteredEvent;
+	void SetIsEnabled(bool bNewValue);
+	bool IsEnabled() const { return bEnabled; }
 	
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bEnabled = false;
 
+	// Sample the swing from the montage between frames instead of sweeping a straight line from the previous location,
+	// so fast swings at low frame rate follow the arc and don't skip targets
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Substepping")
+	bool bPoseSubstepping = false;
+
+	// Samples per second of the swing
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Substepping", meta=(ClampMin=1.f, UIMin=1.f, EditCondition="bPoseSubstepping"))
+	float SubstepRate = 120.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Substepping", meta=(ClampMin=1, UIMin=1, EditCondition="bPoseSubstepping"))
+	int32 MaxSubsteps = 8;
+
 private:
+	USkeletalMeshComponent* GetAttachMesh(FName& OutBoneName) const;
+	void AddSubstepPoints(float DeltaTime, const FVector& CurrentLocation, TArray<FVector, TInlineAllocator<8>>& OutPoints);
+
 	FVector PreviousLocation = FVector::ZeroVector;
+
+	// previous frame state for pose substepping
+	FTransform PreviousMeshTransform = FTransform::Identity;
+	TWeakObjectPtr<const UAnimMontage> PreviousMontage;
+	float PreviousMontagePosition = 0.f;
+
+	GCAnimUtils::FMontageBoneSampler BoneSampler;
 };
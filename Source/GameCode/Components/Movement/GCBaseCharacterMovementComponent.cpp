@@ -7,7 +7,6 @@
 #include "Components/CapsuleComponent.h"
 #include "Curves/CurveVector.h"
 #include "GameCode/GameCode.h"
-#include "GameCode/GCDebugSubsystem.h"
 #include "GameCode/Actors/Interactive/Environment/Ladder.h"
 #include "GameCode/Characters/GCBaseCharacter.h"
 #include "GameCode/Data/Movement/GCMovementMode.h"
@@ -15,7 +14,8 @@
 #include "GameCode/Data/Movement/WakeUpParams.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "Utils/DebugUtils.h"
+#include "Utils/GCTraceUtils.h"
 
 void UGCBaseCharacterMovementComponent::BeginPlay()
 {
@@ -485,6 +485,7 @@ bool UGCBaseCharacterMovementComponent::IsMantling() const
 
 void UGCBaseCharacterMovementComponent::PhysCustomMantling(float DeltaTime, int32 Iterations)
 {
+	GC_TRACE_SCOPE(UGCBaseCharacterMovementComponent_PhysCustomMantling);
 	float ElapsedTime = GetWorld()->GetTimerManager().GetTimerElapsed(MantlingTimerHandle) + MantlingParameters.StartTime;
 	FVector CurveValue = MantlingParameters.MantlingCurve->GetVectorValue(ElapsedTime);
 	float PositionAlpha = CurveValue.X;
@@ -621,6 +622,7 @@ float UGCBaseCharacterMovementComponent::GetClimbingSpeedRatio() const
 
 void UGCBaseCharacterMovementComponent::PhysCustomClimbing(float DeltaTime, int32 Iterations)
 {
+	GC_TRACE_SCOPE(UGCBaseCharacterMovementComponent_PhysCustomClimbing);
 	CalcVelocity(DeltaTime, 2.f, false, ClimbingBrakingDeceleration);
 	FVector Delta = Velocity * DeltaTime;
 	FHitResult Hit;
@@ -680,11 +682,14 @@ bool UGCBaseCharacterMovementComponent::IsZiplining() const
 
 void UGCBaseCharacterMovementComponent::PhysCustomZiplining(float DeltaTime, int32 Iterations)
 {
+	GC_TRACE_SCOPE(UGCBaseCharacterMovementComponent_PhysCustomZiplining);
 	const float G = -GetGravityZ();
 	ZiplineParams.CurrentSpeed = ZiplineParams.CurrentSpeed + DeltaTime * G *
 		(ZiplineParams.DeclinationAngleSin - ZiplineParams.Friction * ZiplineParams.DeclinationAngleCos);
-	GEngine->AddOnScreenDebugMessage(3, 3, FColor::Green,
-		FString::Printf(TEXT("Zipline unclamped speed: %f"), ZiplineParams.CurrentSpeed));
+	if (GCDebug::IsCategoryEnabled(EGCDebugCategory::Movement))
+	{
+		GCDebug::AddMessage(3, 3, FColor::Green, FString::Printf(TEXT("Zipline unclamped speed: %f"), ZiplineParams.CurrentSpeed));
+	}
 	Velocity = FMath::Clamp(ZiplineParams.CurrentSpeed, MinZiplineSpeed, MaxZiplineSpeed) * ZiplineParams.ZiplineNormalizedDirection;
 	
 	const FVector UncorrectedCharacterLocation = GetActorLocation();
@@ -779,23 +784,19 @@ bool UGCBaseCharacterMovementComponent::IsSurfaceWallrunnable(const FVector& Sur
 FVector UGCBaseCharacterMovementComponent::GetWallrunSurfaceNormal(const ESide& Side, const FVector& CharacterLocationDelta) const
 {
 	const int SideModificator = WallrunData.GetSideModificator(Side);
-#if ENABLE_DRAW_DEBUG
-	bool bDebugEnabled = GetDebugSubsystem()->IsDebugCategoryEnabled(DebugCategoryWallrun);
-#else
-	bool bDebugEnabled = false;
-#endif
+	const bool bDebugEnabled = GCDebug::IsCategoryEnabled(EGCDebugCategory::Wallrun);
 	
 	const float CharacterScaleZ = CharacterOwner->GetActorScale().Z;
 	FVector FeetPosition = GetActorLocation() + CharacterLocationDelta
 		- FVector::UpVector * WallrunSettings.FeetTraceActorZOffset * CharacterScaleZ;
 	const FVector DirectionVector = CharacterOwner->GetActorRightVector() * SideModificator;
-	ETraceTypeQuery TraceType = UEngineTypes::ConvertToTraceType(ECC_Wallrunnable);
 	FHitResult FeetHit;
-	EDrawDebugTrace::Type TraceDebug = bDebugEnabled ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None;
+	const GCTraceUtils::FTraceParams TraceParams(bDebugEnabled);
+	const FCollisionQueryParams& QueryParams = CharacterQueryParams.Get(CharacterOwner);
 	float CapsuleRadius = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
-	bool bFeetTouch = UKismetSystemLibrary::LineTraceSingle(this, FeetPosition,
-		FeetPosition + DirectionVector * (WallrunSettings.WallDistance + CapsuleRadius), TraceType,
-		false,TArray<AActor*>(), TraceDebug, FeetHit, true);
+	bool bFeetTouch = GCTraceUtils::LineTraceSingleByChannel(GetWorld(), FeetHit, FeetPosition,
+		FeetPosition + DirectionVector * (WallrunSettings.WallDistance + CapsuleRadius), ECC_Wallrunnable,
+		QueryParams, TraceParams);
 	if (!bFeetTouch)
 	{
 		return FVector::ZeroVector;
@@ -807,9 +808,9 @@ FVector UGCBaseCharacterMovementComponent::GetWallrunSurfaceNormal(const ESide&
 
 	// for inclined walls 
 	const float HandTraceExtendFactor = 4.f;
-	bool bHandTouch = UKismetSystemLibrary::LineTraceSingle(this, HandPosition,
-		HandPosition + DirectionVector * (WallrunSettings.WallDistance * HandTraceExtendFactor + CapsuleRadius), TraceType,
-		false,TArray<AActor*>(), TraceDebug, HandHit, true);
+	bool bHandTouch = GCTraceUtils::LineTraceSingleByChannel(GetWorld(), HandHit, HandPosition,
+		HandPosition + DirectionVector * (WallrunSettings.WallDistance * HandTraceExtendFactor + CapsuleRadius), ECC_Wallrunnable,
+		QueryParams, TraceParams);
 
 	if (!bHandTouch)
 	{
@@ -864,6 +865,7 @@ void UGCBaseCharacterMovementComponent::JumpOffWall()
 
 void UGCBaseCharacterMovementComponent::PhysCustomWallRun(float DeltaTime, int32 iterations)
 {
+	GC_TRACE_SCOPE(UGCBaseCharacterMovementComponent_PhysCustomWallRun);
 	const float ForwardInputThreshold = 0.2f;
 	if (CurrentForwardInput < ForwardInputThreshold)
 	{
@@ -1019,13 +1021,14 @@ void UGCBaseCharacterMovementComponent::ResetSlide()
 
 void UGCBaseCharacterMovementComponent::PhysCustomSliding(float DeltaTime, int32 Iterations)
 {
+	GC_TRACE_SCOPE(UGCBaseCharacterMovementComponent_PhysCustomSliding);
 	const float G = -GetGravityZ();
 	FHitResult FloorCheckHit;
-	FCollisionQueryParams FloorCheckCollisionQueryParams;
-	FloorCheckCollisionQueryParams.AddIgnoredActor(CharacterOwner);
+	const FCollisionQueryParams& FloorCheckCollisionQueryParams = CharacterQueryParams.Get(CharacterOwner);
 	const auto CapsuleShape = CharacterOwner->GetCapsuleComponent()->GetCollisionShape();
 	const float TraceDepth = 3.f;
 	const FVector FloorTraceStartLocation = GetActorLocation();
+	GC_COUNT_TRACES(1);
 	bool bApplyGravity = !GetWorld()->SweepSingleByChannel(FloorCheckHit, FloorTraceStartLocation,
 		FloorTraceStartLocation - CharacterOwner->GetActorUpVector() * TraceDepth,
 		FQuat::Identity, ECC_Visibility, CapsuleShape, FloorCheckCollisionQueryParams);
@@ -1198,25 +1201,15 @@ bool UGCBaseCharacterMovementComponent::IsInCustomMovementMode(const EGCMovement
 	return MovementMode == MOVE_Custom && CustomMovementMode == (uint8)Mode;
 }
 
-UGCDebugSubsystem* UGCBaseCharacterMovementComponent::GetDebugSubsystem() const
-{
-	if (!IsValid(DebugSubsystem))
-	{
-		DebugSubsystem = UGameplayStatics::GetGameInstance(GetWorld())->GetSubsystem<UGCDebugSubsystem>();
-	}
-
-	return DebugSubsystem;
-}
-
 EMovementMode UGCBaseCharacterMovementComponent::GetMovementMode()
 {
 	FHitResult CheckFloorHit;
 	const FVector TraceStart = GetActorLocation() - FVector::UpVector * CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 	const float LineTraceExtend = 50.f;
 	const FVector TraceEnd = TraceStart - FVector::UpVector * LineTraceExtend;
-	FCollisionQueryParams CollisionQueryParams;
-	CollisionQueryParams.AddIgnoredActor(CharacterOwner);
-	bool bOnGround = GetWorld()->LineTraceSingleByChannel(CheckFloorHit, TraceStart, TraceEnd, ECC_Visibility, CollisionQueryParams);
+	GC_COUNT_TRACES(1);
+	bool bOnGround = GetWorld()->LineTraceSingleByChannel(CheckFloorHit, TraceStart, TraceEnd, ECC_Visibility,
+		CharacterQueryParams.Get(CharacterOwner));
 	return bOnGround ? EMovementMode::MOVE_Walking : EMovementMode::MOVE_Falling;
 }
 
@@ -16,6 +16,7 @@
 #include "GameCode/Data/Movement/WallrunSettings.h"
 #include "GameCode/Data/Movement/ZiplineParams.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Utils/GCTraceUtils.h"
 #include "GCBaseCharacterMovementComponent.generated.h"
 
 DECLARE_DELEGATE_OneParam(FCrouchedOrProned, float HalfHeightAdjust)
@@ -240,8 +241,9 @@ private:
 
 	bool IsSurfaceWallrunnable(const FVector& SurfaceNormal) const;
 
-	mutable class UGCDebugSubsystem* DebugSubsystem;
-	UGCDebugSubsystem* GetDebugSubsystem() const;
+	// shared by wallrun, slide and floor checks
+	mutable GCTraceUtils::FOwnerChainQueryParams CharacterQueryParams = GCTraceUtils::FOwnerChainQueryParams(FName("GCMovementTrace"));
+
 	bool IsInCustomMovementMode(const EGCMovementMode& Mode) const;
 
 	EMovementMode GetMovementMode();
@@ -3,9 +3,13 @@
 
 #include "GCBasePawnMovementComponent.h"
 
+#include "Utils/DebugUtils.h"
+#include "GameCode.h"
+
 void UGCBasePawnMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 	FActorComponentTickFunction* ThisTickFunction)
 {
+	GC_TRACE_SCOPE(UGCBasePawnMovementComponent_TickComponent);
 	if (ShouldSkipUpdate(DeltaTime))
 		return;
 	
@@ -45,12 +49,18 @@ void UGCBasePawnMovementComponent::Move(float DeltaTime)
 		if (bIsFalling)
 		{
 			VerticalSpeed += GetGravityZ() * DeltaTime;
-			GEngine->AddOnScreenDebugMessage(-1, 2, FColor::Green, TEXT("Falling"));
+			if (GCDebug::IsCategoryEnabled(EGCDebugCategory::Movement))
+			{
+				GCDebug::AddMessage(-1, 2, FColor::Green, TEXT("Falling"));
+			}
 		}
 		else if (bWasFalling && VerticalSpeed < 0)
 		{
 			VerticalSpeed = 0;
-			GEngine->AddOnScreenDebugMessage(-1, 2, FColor::Yellow, TEXT("Not falling"));
+			if (GCDebug::IsCategoryEnabled(EGCDebugCategory::Movement))
+			{
+				GCDebug::AddMessage(-1, 2, FColor::Yellow, TEXT("Not falling"));
+			}
 		}
 
 		Velocity.Z += VerticalSpeed;
@@ -3,6 +3,8 @@
 
 #include "SpiderPawnMovementComponent.h"
 
+#include "Utils/DebugUtils.h"
+
 void USpiderPawnMovementComponent::JumpStart()
 {
 	VerticalSpeed = InitialJumpSpeed;
@@ -22,12 +24,18 @@ void USpiderPawnMovementComponent::Move(float DeltaTime)
 	if (bIsFalling)
 	{
 		VerticalSpeed += GetGravityZ() * DeltaTime;
-		GEngine->AddOnScreenDebugMessage(-1, 2, FColor::Green, TEXT("Falling"));
+		if (GCDebug::IsCategoryEnabled(EGCDebugCategory::Movement))
+		{
+			GCDebug::AddMessage(-1, 2, FColor::Green, TEXT("Falling"));
+		}
 	}
 	else if (VerticalSpeed < 0)
 	{
 		VerticalSpeed = 0;
-		GEngine->AddOnScreenDebugMessage(-1, 2, FColor::Yellow, TEXT("Not falling"));
+		if (GCDebug::IsCategoryEnabled(EGCDebugCategory::Movement))
+		{
+			GCDebug::AddMessage(-1, 2, FColor::Yellow, TEXT("Not falling"));
+		}
 	}
 
 	Velocity.Z += VerticalSpeed;
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "HitboxSettings.generated.h"
+
+// Sphere around a bone, recorded for lag compensation
+USTRUCT(BlueprintType)
+struct FHitboxSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	FName BoneName = NAME_None;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(ClampMin = 1.f, UIMin = 1.f))
+	float Radius = 15.f;
+};
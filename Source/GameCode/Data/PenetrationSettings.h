@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Engine/EngineTypes.h"
+#include "PenetrationSettings.generated.h"
+
+// How much of the bullet damage is left after going through a surface of this type
+USTRUCT(BlueprintType)
+struct FPenetrationSurface
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	TEnumAsByte<EPhysicalSurface> SurfaceType = SurfaceType_Default;
+
+	// 0 - the surface stops bullets
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(ClampMin = 0.f, UIMin = 0.f, ClampMax = 1.f, UIMax = 1.f))
+	float DamageScale = 0.5f;
+};
+
+USTRUCT(BlueprintType)
+struct FPenetrationSettings
+{
+	GENERATED_BODY()
+
+	// Hitscan bullets go through surfaces listed in the table
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	bool bEnabled = false;
+
+	// How many surfaces a bullet can go through before it stops
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(ClampMin = 0, UIMin = 0, EditCondition = "bEnabled"))
+	int32 MaxPenetrations = 2;
+
+	// Bullet stops when its damage scale drops below this
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(ClampMin = 0.f, UIMin = 0.f, ClampMax = 1.f, UIMax = 1.f, EditCondition = "bEnabled"))
+	float MinDamageScale = 0.1f;
+
+	// For surfaces not in the table
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(ClampMin = 0.f, UIMin = 0.f, ClampMax = 1.f, UIMax = 1.f, EditCondition = "bEnabled"))
+	float DefaultDamageScale = 0.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(EditCondition = "bEnabled"))
+	TArray<FPenetrationSurface> Surfaces;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "ShotPacket.generated.h"
+
+// More shots in one server rpc are rejected
+constexpr int32 MaxShotPacketsPerBatch = 32;
+
+// Everything the server needs to replay a shot of a client: pellets are rebuilt from the view and the spread seed,
+// so no directions or hits are sent. The shooter quantizes the view before shooting itself, so both sides trace the same rays
+USTRUCT()
+struct FShotPacket
+{
+	GENERATED_BODY()
+
+	// server world time as the shooter saw it, see AGameStateBase::GetServerWorldTimeSeconds
+	UPROPERTY()
+	float ShooterTime = 0.f;
+
+	UPROPERTY()
+	FVector_NetQuantize10 ViewOrigin = FVector::ZeroVector;
+
+	// FRotator::CompressAxisToShort
+	UPROPERTY()
+	uint16 ViewPitch = 0;
+
+	UPROPERTY()
+	uint16 ViewYaw = 0;
+
+	// state of the spread stream before the shot
+	UPROPERTY()
+	int32 SpreadSeed = 0;
+
+	// index of the barrel in the weapon
+	UPROPERTY()
+	uint8 FireModeIndex = 0;
+
+	UPROPERTY()
+	bool bAiming = false;
+
+	FRotator GetViewRotation() const
+	{
+		return FRotator(FRotator::DecompressAxisFromShort(ViewPitch), FRotator::DecompressAxisFromShort(ViewYaw), 0.f);
+	}
+};
@@ -3,15 +3,34 @@
 
 #include "GCDebugSubsystem.h"
 
-bool UGCDebugSubsystem::IsDebugCategoryEnabled(const FName& CategoryName) const
+#include "Misc/Paths.h"
+#include "Utils/DebugUtils.h"
+
+void UGCDebugSubsystem::Tick(float DeltaTime)
 {
-	const bool* bEnabled = CategoriesStates.Find(CategoryName);
-	return bEnabled && *bEnabled;
+	GCDebug::Flush();
+}
+
+bool UGCDebugSubsystem::IsTickable() const
+{
+	return !IsTemplate() && GCDebug::HasPendingPrimitives();
+}
+
+TStatId UGCDebugSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCDebugSubsystem, STATGROUP_Tickables);
 }
 
 void UGCDebugSubsystem::SetDebugCategoryEnabled(const FName& CategoryName, bool bEnabled)
 {
-	bool& bCategoryEnabled = CategoriesStates.FindOrAdd(CategoryName);
-	bCategoryEnabled = bEnabled;
+	const EGCDebugCategory Category = GCDebug::FindCategory(CategoryName);
+	if (Category != EGCDebugCategory::None)
+	{
+		GCDebug::SetCategoryEnabled(Category, bEnabled);
+	}
 }
 
+void UGCDebugSubsystem::DumpDebugPrimitives()
+{
+	GCDebug::DumpToFile(FPaths::Combine(FPaths::ProjectLogDir(), GCDebug::DumpFileName));
+}
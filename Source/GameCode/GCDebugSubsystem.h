@@ -3,23 +3,29 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Tickable.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "GCDebugSubsystem.generated.h"
 
 /**
- * 
+ * Console front-end for GCDebug categories. Also flushes debug primitive ring buffer once per frame
  */
 UCLASS()
-class GAMECODE_API UGCDebugSubsystem : public UGameInstanceSubsystem
+class GAMECODE_API UGCDebugSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
 {
 	GENERATED_BODY()
 
 public:
-	bool IsDebugCategoryEnabled(const FName& CategoryName) const;
-
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual TStatId GetStatId() const override;
+	
 private:
 	UFUNCTION(Exec)
 	void SetDebugCategoryEnabled(const FName& CategoryName, bool bEnabled);
 
-	TMap<FName, bool> CategoriesStates;
+	// Writes whole ring buffer to Saved/Logs
+	UFUNCTION(Exec)
+	void DumpDebugPrimitives();
 };
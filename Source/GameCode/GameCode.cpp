@@ -1,8 +1,63 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "GameCode.h"
+#include "Misc/CoreDelegates.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, GameCode, "GameCode" );
+UE_TRACE_CHANNEL_DEFINE(GameCodeChannel)
 
-DEFINE_LOG_CATEGORY(LogCameras)
\ No newline at end of file
+TRACE_DECLARE_INT_COUNTER(GCLiveProjectiles, TEXT("GameCode/Live projectiles"));
+TRACE_DECLARE_INT_COUNTER(GCRagdolls, TEXT("GameCode/Ragdolls"));
+TRACE_DECLARE_INT_COUNTER(GCActiveAI, TEXT("GameCode/Active AI"));
+TRACE_DECLARE_INT_COUNTER(GCTracesPerFrame, TEXT("GameCode/Traces per frame"));
+
+FThreadSafeCounter GCTraceCounters::TracesThisFrame;
+
+class FGameCodeModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		RegisterLLMTags();
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FGameCodeModule::OnEndFrame);
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	}
+
+private:
+	static void RegisterLLMTags()
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		const TPair<EGCLLMTag, const TCHAR*> Tags[] = {
+			{ EGCLLMTag::Characters, TEXT("GC_Characters") },
+			{ EGCLLMTag::Equipment, TEXT("GC_Equipment") },
+			{ EGCLLMTag::Projectiles, TEXT("GC_Projectiles") },
+			{ EGCLLMTag::FX, TEXT("GC_FX") },
+			{ EGCLLMTag::AI, TEXT("GC_AI") },
+			{ EGCLLMTag::UI, TEXT("GC_UI") },
+			{ EGCLLMTag::Debug, TEXT("GC_Debug") }
+		};
+		
+		for (const TPair<EGCLLMTag, const TCHAR*>& Tag : Tags)
+		{
+			FLowLevelMemTracker::Get().RegisterProjectTag((int32)Tag.Key, Tag.Value, NAME_None, NAME_None);
+		}
+#endif
+	}
+	
+	static void OnEndFrame()
+	{
+		// Reset returns the count before resetting
+		const int32 TracesCount = GCTraceCounters::TracesThisFrame.Reset();
+		TRACE_COUNTER_SET(GCTracesPerFrame, TracesCount);
+	}
+	
+	FDelegateHandle EndFrameHandle;
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FGameCodeModule, GameCode, "GameCode" );
+
+DEFINE_LOG_CATEGORY(LogCameras)
@@ -3,19 +3,53 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/LowLevelMemTracker.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCameras, Verbose, All)
+
+// Insights: -trace=cpu,counters,gamecode
+UE_TRACE_CHANNEL_EXTERN(GameCodeChannel, GAMECODE_API)
+#define GC_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, GameCodeChannel)
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(GCLiveProjectiles);
+TRACE_DECLARE_INT_COUNTER_EXTERN(GCRagdolls);
+TRACE_DECLARE_INT_COUNTER_EXTERN(GCActiveAI);
+TRACE_DECLARE_INT_COUNTER_EXTERN(GCTracesPerFrame);
+
+namespace GCTraceCounters
+{
+	// Flushed into GCTracesPerFrame at the end of every frame. Traces are counted from anim and task threads too
+	extern GAMECODE_API FThreadSafeCounter TracesThisFrame;
+}
+#define GC_COUNT_TRACES(Count) GCTraceCounters::TracesThisFrame.Add(Count)
+
+// LLM tags, registered by the game module. Soak with -llm -llmcsv to get per tag memory reports
+enum class EGCLLMTag : int32
+{
+	Characters = (int32)ELLMTag::ProjectTagStart,
+	Equipment,
+	Projectiles,
+	FX,
+	AI,
+	UI,
+	Debug
+};
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+#define GC_LLM_SCOPE(Tag) LLM_SCOPE((ELLMTag)EGCLLMTag::Tag)
+#else
+#define GC_LLM_SCOPE(Tag)
+#endif
+
 #define ECC_Climbable ECC_GameTraceChannel1
 #define ECC_Interactable ECC_GameTraceChannel2
 #define ECC_Wallrunnable ECC_GameTraceChannel3
 #define ECC_Bullet ECC_GameTraceChannel4
 #define ECC_MeleeHitRegistrator ECC_GameTraceChannel5
-
-const FName DebugCategoryLedgeDetection = FName("LedgeDetection");
-const FName DebugCategoryWallrun = FName("Wallrun");
-const FName DebugCategoryAttributes = FName("Attributes");
-const FName DebugCategoryRangeWeapons = FName("RangeWeapons");
-const FName DebugCategoryMeleeWeapons = FName("MeleeWeapons");
+#define ECC_ExplosionOcclusion ECC_GameTraceChannel6
 
 const FName ProfilePawn = FName("Pawn");
 const FName ProfileRagdoll = FName("Ragdoll");
@@ -30,3 +64,6 @@ const FName SocketAssaultRifle = FName("hand_r_assault_rifle_socket");
 const FName SocketForegrip = FName("foregrip_socket");
 
 const FName FXParamTraceEnd = FName("TraceEnd");
+const FName FXParamTracerStarts = FName("TracerStarts");
+const FName FXParamTracerEnds = FName("TracerEnds");
+const FName FXParamTracerCount = FName("TracerCount");
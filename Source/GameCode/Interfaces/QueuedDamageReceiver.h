@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "QueuedDamageReceiver.generated.h"
+
+class UDamageType;
+
+// All damage an actor took during a frame
+struct FQueuedDamage
+{
+	float Damage = 0.f;
+	int32 HitsCount = 0;
+	// of the biggest hit
+	float BiggestHitDamage = 0.f;
+	TWeakObjectPtr<const UDamageType> DamageType;
+	TWeakObjectPtr<AController> InstigatedBy;
+	TWeakObjectPtr<AActor> DamageCauser;
+};
+
+UINTERFACE()
+class UQueuedDamageReceiver : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors registered in UGCDamageQueueSubsystem get their damage once per frame, summed, instead of on every TakeDamage
+ */
+class GAMECODE_API IQueuedDamageReceiver
+{
+	GENERATED_BODY()
+
+public:
+	virtual void ApplyQueuedDamage(const FQueuedDamage& QueuedDamage) {}
+};
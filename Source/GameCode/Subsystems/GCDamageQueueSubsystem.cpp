@@ -0,0 +1,69 @@
+#include "GCDamageQueueSubsystem.h"
+
+#include "GameCode.h"
+
+DECLARE_STATS_GROUP(TEXT("GameCode Damage Queue"), STATGROUP_GCDamageQueue, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queued hits"), STAT_GCDamageQueueHits, STATGROUP_GCDamageQueue);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Applied damage"), STAT_GCDamageQueueApplied, STATGROUP_GCDamageQueue);
+
+void UGCDamageQueueSubsystem::Deinitialize()
+{
+	PendingDamage.Empty();
+	FlushedDamage.Empty();
+	Super::Deinitialize();
+}
+
+void UGCDamageQueueSubsystem::Tick(float DeltaTime)
+{
+	GC_TRACE_SCOPE(UGCDamageQueueSubsystem_Flush);
+	Swap(PendingDamage, FlushedDamage);
+	for (const TPair<TWeakObjectPtr<AActor>, FQueuedDamage>& Damage : FlushedDamage)
+	{
+		IQueuedDamageReceiver* Receiver = Cast<IQueuedDamageReceiver>(Damage.Key.Get());
+		if (Receiver != nullptr)
+		{
+			INC_DWORD_STAT(STAT_GCDamageQueueApplied);
+			Receiver->ApplyQueuedDamage(Damage.Value);
+		}
+	}
+
+	FlushedDamage.Reset();
+}
+
+bool UGCDamageQueueSubsystem::IsTickable() const
+{
+	return !IsTemplate() && PendingDamage.Num() > 0;
+}
+
+TStatId UGCDamageQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCDamageQueueSubsystem, STATGROUP_Tickables);
+}
+
+void UGCDamageQueueSubsystem::RegisterReceiver(AActor* Receiver)
+{
+	checkf(Cast<IQueuedDamageReceiver>(Receiver) != nullptr, TEXT("Damage queue receivers must implement IQueuedDamageReceiver"));
+	Receiver->OnTakeAnyDamage.AddUniqueDynamic(this, &UGCDamageQueueSubsystem::OnTakeAnyDamage);
+}
+
+void UGCDamageQueueSubsystem::UnregisterReceiver(AActor* Receiver)
+{
+	Receiver->OnTakeAnyDamage.RemoveDynamic(this, &UGCDamageQueueSubsystem::OnTakeAnyDamage);
+	PendingDamage.Remove(Receiver);
+}
+
+void UGCDamageQueueSubsystem::OnTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
+	AController* InstigatedBy, AActor* DamageCauser)
+{
+	INC_DWORD_STAT(STAT_GCDamageQueueHits);
+	FQueuedDamage& QueuedDamage = PendingDamage.FindOrAdd(DamagedActor);
+	QueuedDamage.Damage += Damage;
+	QueuedDamage.HitsCount++;
+	if (Damage >= QueuedDamage.BiggestHitDamage)
+	{
+		QueuedDamage.BiggestHitDamage = Damage;
+		QueuedDamage.DamageType = DamageType;
+		QueuedDamage.InstigatedBy = InstigatedBy;
+		QueuedDamage.DamageCauser = DamageCauser;
+	}
+}
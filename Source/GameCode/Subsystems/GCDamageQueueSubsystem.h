@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Interfaces/QueuedDamageReceiver.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCDamageQueueSubsystem.generated.h"
+
+/**
+ * Collects damage taken by registered receivers during the frame and hands it over once per receiver at the end of the frame.
+ * Shotgun pellets and explosions hitting the same victim result in one health change, one hit reaction and one UI update
+ */
+UCLASS()
+class GAMECODE_API UGCDamageQueueSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	// Receiver's OnTakeAnyDamage goes to the queue
+	void RegisterReceiver(AActor* Receiver);
+	void UnregisterReceiver(AActor* Receiver);
+
+private:
+	UFUNCTION()
+	void OnTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
+
+	TMap<TWeakObjectPtr<AActor>, FQueuedDamage> PendingDamage;
+	// swapped with PendingDamage on flush, so damage caused by damage goes to the next frame
+	TMap<TWeakObjectPtr<AActor>, FQueuedDamage> FlushedDamage;
+};
@@ -0,0 +1,203 @@
+#include "GCDecalSubsystem.h"
+
+#include "GameCode.h"
+#include "Components/DecalComponent.h"
+#include "Data/DecalSettings.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_STATS_GROUP(TEXT("GameCode Decals"), STATGROUP_GCDecals, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Decal components"), STAT_GCDecalComponents, STATGROUP_GCDecals);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Visible decals"), STAT_GCVisibleDecals, STATGROUP_GCDecals);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawned decals"), STAT_GCSpawnedDecals, STATGROUP_GCDecals);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Recycled decals"), STAT_GCRecycledDecals, STATGROUP_GCDecals);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dropped decals"), STAT_GCDroppedDecals, STATGROUP_GCDecals);
+
+static int32 DecalsPerMaterial = 64;
+static FAutoConsoleVariableRef CVarDecalsPerMaterial(
+	TEXT("gc.Decals.MaxPerMaterial"),
+	DecalsPerMaterial,
+	TEXT("Capacity of impact decals ring per material. Oldest decal is reused when the ring is full"));
+
+static int32 DecalsPerFrame = 16;
+static FAutoConsoleVariableRef CVarDecalsPerFrame(
+	TEXT("gc.Decals.MaxPerFrame"),
+	DecalsPerFrame,
+	TEXT("Impact decals spawned above this amount in one frame are dropped"));
+
+static float DecalsMaxDistance = 5000.f;
+static FAutoConsoleVariableRef CVarDecalsMaxDistance(
+	TEXT("gc.Decals.MaxDistance"),
+	DecalsMaxDistance,
+	TEXT("Impact decals further than this from every local player camera are dropped. 0 - no limit"));
+
+static float DecalsExpireCheckInterval = 0.5f;
+
+void UGCDecalSubsystem::Deinitialize()
+{
+	for (TPair<UMaterialInterface*, FDecalRing>& Ring : Rings)
+	{
+		for (UDecalComponent* Decal : Ring.Value.Decals)
+		{
+			if (IsValid(Decal))
+			{
+				Decal->DestroyComponent();
+			}
+		}
+
+		DEC_DWORD_STAT_BY(STAT_GCDecalComponents, Ring.Value.Decals.Num());
+	}
+
+	DEC_DWORD_STAT_BY(STAT_GCVisibleDecals, VisibleDecalsCount);
+	VisibleDecalsCount = 0;
+	Rings.Empty();
+	Super::Deinitialize();
+}
+
+void UGCDecalSubsystem::Tick(float DeltaTime)
+{
+	TimeToExpireCheck -= DeltaTime;
+	if (TimeToExpireCheck > 0.f)
+	{
+		return;
+	}
+
+	// faded out decals are hidden, so they don't cost anything until they're reused
+	GC_TRACE_SCOPE(UGCDecalSubsystem_HideExpiredDecals);
+	TimeToExpireCheck = DecalsExpireCheckInterval;
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	for (TPair<UMaterialInterface*, FDecalRing>& Ring : Rings)
+	{
+		FDecalRing& DecalRing = Ring.Value;
+		for (int32 i = 0; i < DecalRing.Decals.Num(); ++i)
+		{
+			UDecalComponent* Decal = DecalRing.Decals[i];
+			if (DecalRing.ExpireTimes[i] <= CurrentTime && IsValid(Decal) && Decal->IsVisible())
+			{
+				Decal->SetVisibility(false);
+				VisibleDecalsCount--;
+				DEC_DWORD_STAT(STAT_GCVisibleDecals);
+			}
+		}
+	}
+}
+
+bool UGCDecalSubsystem::IsTickable() const
+{
+	return !IsTemplate() && VisibleDecalsCount > 0;
+}
+
+TStatId UGCDecalSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCDecalSubsystem, STATGROUP_Tickables);
+}
+
+UDecalComponent* UGCDecalSubsystem::SpawnDecal(const FDecalSettings& DecalSettings, const FVector& Location,
+	const FRotator& Rotation, const FVector& Size)
+{
+	GC_TRACE_SCOPE(UGCDecalSubsystem_SpawnDecal);
+	if (!IsValid(DecalSettings.Material) || !IsWithinBudget(Location))
+	{
+		INC_DWORD_STAT(STAT_GCDroppedDecals);
+		return nullptr;
+	}
+
+	FDecalRing& Ring = Rings.FindOrAdd(DecalSettings.Material);
+	UDecalComponent* Decal = nullptr;
+	if (Ring.Decals.Num() < FMath::Max(DecalsPerMaterial, 1))
+	{
+		Decal = CreateDecal(DecalSettings.Material);
+		Ring.Decals.Add(Decal);
+		Ring.ExpireTimes.Add(0.f);
+		Ring.Head = Ring.Decals.Num() - 1;
+	}
+	else
+	{
+		Ring.Head = (Ring.Head + 1) % Ring.Decals.Num();
+		Decal = Ring.Decals[Ring.Head];
+		if (!IsValid(Decal))
+		{
+			Decal = CreateDecal(DecalSettings.Material);
+			Ring.Decals[Ring.Head] = Decal;
+		}
+		else if (Decal->IsVisible())
+		{
+			// reusing the oldest decal while it's still on screen
+			INC_DWORD_STAT(STAT_GCRecycledDecals);
+			VisibleDecalsCount--;
+			DEC_DWORD_STAT(STAT_GCVisibleDecals);
+		}
+	}
+
+	INC_DWORD_STAT(STAT_GCSpawnedDecals);
+	VisibleDecalsCount++;
+	INC_DWORD_STAT(STAT_GCVisibleDecals);
+
+	Decal->DecalSize = Size;
+	Decal->SetWorldLocationAndRotation(Location, Rotation);
+	Decal->SetVisibility(true);
+	// restarts the fade, but the component must survive it to be reused
+	Decal->SetFadeOut(DecalSettings.LifeTime, DecalSettings.FadeOutTime, false);
+	Decal->SetLifeSpan(0.f);
+	Decal->MarkRenderStateDirty();
+
+	const float TotalLifeTime = DecalSettings.LifeTime + DecalSettings.FadeOutTime;
+	Ring.ExpireTimes[Ring.Head] = TotalLifeTime > 0.f ? GetWorld()->GetTimeSeconds() + TotalLifeTime : FLT_MAX;
+	return Decal;
+}
+
+bool UGCDecalSubsystem::IsWithinBudget(const FVector& Location)
+{
+	UWorld* World = GetWorld();
+	if (World->GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+
+	if (LastSpawnFrame != GFrameCounter)
+	{
+		LastSpawnFrame = GFrameCounter;
+		SpawnedThisFrame = 0;
+	}
+
+	if (SpawnedThisFrame >= DecalsPerFrame)
+	{
+		return false;
+	}
+
+	if (DecalsMaxDistance > 0.f)
+	{
+		bool bNearLocalPlayer = false;
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			const APlayerController* PlayerController = It->Get();
+			if (IsValid(PlayerController) && PlayerController->IsLocalController() && IsValid(PlayerController->PlayerCameraManager)
+				&& FVector::DistSquared(PlayerController->PlayerCameraManager->GetCameraLocation(), Location) <= FMath::Square(DecalsMaxDistance))
+			{
+				bNearLocalPlayer = true;
+				break;
+			}
+		}
+
+		if (!bNearLocalPlayer)
+		{
+			return false;
+		}
+	}
+
+	SpawnedThisFrame++;
+	return true;
+}
+
+UDecalComponent* UGCDecalSubsystem::CreateDecal(UMaterialInterface* Material)
+{
+	GC_LLM_SCOPE(FX);
+	UDecalComponent* Decal = NewObject<UDecalComponent>(this);
+	Decal->bAllowAnyoneToDestroyMe = true;
+	Decal->SetDecalMaterial(Material);
+	Decal->SetUsingAbsoluteScale(true);
+	Decal->SetFadeScreenSize(0.0001f);
+	Decal->RegisterComponentWithWorld(GetWorld());
+	INC_DWORD_STAT(STAT_GCDecalComponents);
+	return Decal;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCDecalSubsystem.generated.h"
+
+struct FDecalSettings;
+class UDecalComponent;
+
+USTRUCT()
+struct FDecalRing
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<UDecalComponent*> Decals;
+
+	TArray<float> ExpireTimes;
+	int32 Head = 0;
+};
+
+/**
+ * Impact decals. Keeps a fixed capacity ring of decal components per material and reuses the oldest one when the ring is full
+ * instead of creating a new component for every hit. Counts are in stat GCDecals
+ */
+UCLASS()
+class GAMECODE_API UGCDecalSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	// Returns nullptr if decal was dropped by distance or per frame budget
+	UDecalComponent* SpawnDecal(const FDecalSettings& DecalSettings, const FVector& Location, const FRotator& Rotation, const FVector& Size);
+
+private:
+	bool IsWithinBudget(const FVector& Location);
+	UDecalComponent* CreateDecal(UMaterialInterface* Material);
+
+	UPROPERTY()
+	TMap<UMaterialInterface*, FDecalRing> Rings;
+
+	uint64 LastSpawnFrame = 0;
+	int32 SpawnedThisFrame = 0;
+	int32 VisibleDecalsCount = 0;
+	float TimeToExpireCheck = 0.f;
+};
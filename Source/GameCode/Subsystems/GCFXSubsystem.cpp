@@ -0,0 +1,273 @@
+#include "GCFXSubsystem.h"
+
+#include "GameCode.h"
+#include "NiagaraComponent.h"
+#include "NiagaraComponentPool.h"
+#include "NiagaraFunctionLibrary.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/AudioComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
+
+DECLARE_STATS_GROUP(TEXT("GameCode FX"), STATGROUP_GCFX, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Niagara spawns"), STAT_GCFXNiagaraSpawns, STATGROUP_GCFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cascade spawns"), STAT_GCFXCascadeSpawns, STATGROUP_GCFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sound spawns"), STAT_GCFXSoundSpawns, STATGROUP_GCFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled sound plays"), STAT_GCFXPooledSoundPlays, STATGROUP_GCFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled sound voice steals"), STAT_GCFXVoiceSteals, STATGROUP_GCFX);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled audio components"), STAT_GCFXPooledAudioComponents, STATGROUP_GCFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Culled by distance"), STAT_GCFXCulled, STATGROUP_GCFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dropped by budget"), STAT_GCFXDropped, STATGROUP_GCFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Niagara pool hits"), STAT_GCFXPoolHits, STATGROUP_GCFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Niagara pool misses"), STAT_GCFXPoolMisses, STATGROUP_GCFX);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Niagara pool hit rate %"), STAT_GCFXPoolHitRate, STATGROUP_GCFX);
+
+static int32 FXSpawnsPerFrame = 32;
+static FAutoConsoleVariableRef CVarFXSpawnsPerFrame(
+	TEXT("gc.FX.MaxSpawnsPerFrame"),
+	FXSpawnsPerFrame,
+	TEXT("Fx and one shot sounds spawned above this amount in one frame are dropped"));
+
+static float FXCullDistance = 8000.f;
+static FAutoConsoleVariableRef CVarFXCullDistance(
+	TEXT("gc.FX.CullDistance"),
+	FXCullDistance,
+	TEXT("Fx further than this from every local player camera are not spawned. 0 - no culling"));
+
+UNiagaraComponent* UGCFXSubsystem::SpawnNiagaraAtLocation(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation)
+{
+	GC_TRACE_SCOPE(UGCFXSubsystem_SpawnNiagaraAtLocation);
+	if (!IsValid(System) || !CanSpawn(Location))
+	{
+		return nullptr;
+	}
+
+	GC_LLM_SCOPE(FX);
+	INC_DWORD_STAT(STAT_GCFXNiagaraSpawns);
+	UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), System, Location, Rotation,
+		FVector::OneVector, true, true, ENCPoolMethod::AutoRelease);
+	TrackNiagaraSpawn(Component, System);
+	return Component;
+}
+
+UParticleSystemComponent* UGCFXSubsystem::SpawnCascadeAtLocation(UParticleSystem* ParticleSystem, const FVector& Location,
+	const FRotator& Rotation)
+{
+	GC_TRACE_SCOPE(UGCFXSubsystem_SpawnCascadeAtLocation);
+	if (!IsValid(ParticleSystem) || !CanSpawn(Location))
+	{
+		return nullptr;
+	}
+
+	GC_LLM_SCOPE(FX);
+	INC_DWORD_STAT(STAT_GCFXCascadeSpawns);
+	return UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ParticleSystem, FTransform(Rotation, Location), true,
+		EPSCPoolMethod::AutoRelease);
+}
+
+void UGCFXSubsystem::PlaySoundAtLocation(USoundBase* Sound, const FVector& Location)
+{
+	if (!IsValid(Sound) || !CanSpawn(Location))
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_GCFXSoundSpawns);
+	UGameplayStatics::PlaySoundAtLocation(GetWorld(), Sound, Location);
+}
+
+void UGCFXSubsystem::PlaySoundAttached(USoundBase* Sound, USceneComponent* AttachToComponent)
+{
+	if (!IsValid(Sound) || !IsValid(AttachToComponent) || !CanSpawn(AttachToComponent->GetComponentLocation()))
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_GCFXSoundSpawns);
+	UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent);
+}
+
+void UGCFXSubsystem::PlaySoundPooled(FPooledSoundEmitter& Emitter, USoundBase* Sound, USceneComponent* AttachToComponent,
+	int32 MaxVoices, USoundConcurrency* Concurrency)
+{
+	GC_TRACE_SCOPE(UGCFXSubsystem_PlaySoundPooled);
+	if (!IsValid(Sound) || !IsValid(AttachToComponent) || !CanSpawn(AttachToComponent->GetComponentLocation()))
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_GCFXPooledSoundPlays);
+	UAudioComponent* Voice = nullptr;
+	for (UAudioComponent* PooledVoice : Emitter.Voices)
+	{
+		if (IsValid(PooledVoice) && !PooledVoice->IsPlaying())
+		{
+			Voice = PooledVoice;
+			break;
+		}
+	}
+
+	if (Voice == nullptr && Emitter.Voices.Num() < FMath::Max(MaxVoices, 1))
+	{
+		GC_LLM_SCOPE(FX);
+		Voice = NewObject<UAudioComponent>(AttachToComponent->GetOwner());
+		Voice->bAutoActivate = false;
+		Voice->bAutoDestroy = false;
+		Voice->bStopWhenOwnerDestroyed = true;
+		Voice->SetupAttachment(AttachToComponent);
+		if (IsValid(Concurrency))
+		{
+			Voice->ConcurrencySet.Add(Concurrency);
+		}
+		
+		Voice->RegisterComponent();
+		Emitter.Voices.Add(Voice);
+		INC_DWORD_STAT(STAT_GCFXPooledAudioComponents);
+	}
+
+	if (Voice == nullptr)
+	{
+		// all voices are busy, the oldest one is restarted
+		Emitter.NextVoiceIndex = Emitter.NextVoiceIndex % Emitter.Voices.Num();
+		Voice = Emitter.Voices[Emitter.NextVoiceIndex];
+		Emitter.NextVoiceIndex++;
+		INC_DWORD_STAT(STAT_GCFXVoiceSteals);
+		if (!IsValid(Voice))
+		{
+			return;
+		}
+	}
+
+	if (Voice->Sound != Sound)
+	{
+		Voice->SetSound(Sound);
+	}
+	
+	Voice->Play();
+}
+
+void UGCFXSubsystem::ReleaseSoundEmitter(FPooledSoundEmitter& Emitter)
+{
+	for (UAudioComponent* Voice : Emitter.Voices)
+	{
+		if (IsValid(Voice))
+		{
+			Voice->DestroyComponent();
+		}
+	}
+
+	DEC_DWORD_STAT_BY(STAT_GCFXPooledAudioComponents, Emitter.Voices.Num());
+	Emitter.Voices.Empty();
+	Emitter.NextVoiceIndex = 0;
+}
+
+void UGCFXSubsystem::PrewarmNiagara(UNiagaraSystem* System, int32 Count)
+{
+	if (!IsValid(System) || GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	GC_TRACE_SCOPE(UGCFXSubsystem_PrewarmNiagara);
+	GC_LLM_SCOPE(FX);
+	FNiagaraPoolUsage& PoolUsage = NiagaraPoolUsages.FindOrAdd(System);
+	for (int32 i = PoolUsage.AllocatedCount; i < Count; ++i)
+	{
+		// inactive manually released components go straight to the world's niagara pool,
+		// where auto release spawns of the same system pick them up
+		UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), System, FVector::ZeroVector,
+			FRotator::ZeroRotator, FVector::OneVector, false, false, ENCPoolMethod::ManualRelease, false);
+		if (IsValid(Component))
+		{
+			Component->ReleaseToPool();
+			PoolUsage.AllocatedCount++;
+		}
+	}
+}
+
+bool UGCFXSubsystem::CanSpawn(const FVector& Location)
+{
+	if (GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+
+	if (!IsWithinCullDistance(Location))
+	{
+		INC_DWORD_STAT(STAT_GCFXCulled);
+		return false;
+	}
+
+	if (LastSpawnFrame != GFrameCounter)
+	{
+		LastSpawnFrame = GFrameCounter;
+		SpawnedThisFrame = 0;
+	}
+
+	if (SpawnedThisFrame >= FXSpawnsPerFrame)
+	{
+		INC_DWORD_STAT(STAT_GCFXDropped);
+		return false;
+	}
+
+	SpawnedThisFrame++;
+	return true;
+}
+
+bool UGCFXSubsystem::IsWithinCullDistance(const FVector& Location) const
+{
+	if (FXCullDistance <= 0.f)
+	{
+		return true;
+	}
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (IsValid(PlayerController) && PlayerController->IsLocalController() && IsValid(PlayerController->PlayerCameraManager)
+			&& FVector::DistSquared(PlayerController->PlayerCameraManager->GetCameraLocation(), Location) <= FMath::Square(FXCullDistance))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UGCFXSubsystem::TrackNiagaraSpawn(UNiagaraComponent* Component, UNiagaraSystem* System)
+{
+	if (!IsValid(Component))
+	{
+		return;
+	}
+
+	// niagara pool doesn't report hits, so it's estimated: a spawn is a hit while there are fewer live components
+	// of the system than it has ever allocated
+	FNiagaraPoolUsage& PoolUsage = NiagaraPoolUsages.FindOrAdd(System);
+	if (PoolUsage.LiveCount < PoolUsage.AllocatedCount)
+	{
+		PoolHits++;
+		INC_DWORD_STAT(STAT_GCFXPoolHits);
+	}
+	else
+	{
+		PoolMisses++;
+		PoolUsage.AllocatedCount++;
+		INC_DWORD_STAT(STAT_GCFXPoolMisses);
+	}
+
+	PoolUsage.LiveCount++;
+	Component->OnSystemFinished.AddUniqueDynamic(this, &UGCFXSubsystem::OnNiagaraSystemFinished);
+	SET_FLOAT_STAT(STAT_GCFXPoolHitRate, 100.f * PoolHits / (PoolHits + PoolMisses));
+}
+
+void UGCFXSubsystem::OnNiagaraSystemFinished(UNiagaraComponent* Component)
+{
+	Component->OnSystemFinished.RemoveDynamic(this, &UGCFXSubsystem::OnNiagaraSystemFinished);
+	FNiagaraPoolUsage* PoolUsage = NiagaraPoolUsages.Find(Component->GetAsset());
+	if (PoolUsage != nullptr)
+	{
+		PoolUsage->LiveCount = FMath::Max(PoolUsage->LiveCount - 1, 0);
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCFXSubsystem.generated.h"
+
+class UAudioComponent;
+class UNiagaraComponent;
+class UNiagaraSystem;
+class UParticleSystem;
+class UParticleSystemComponent;
+class USoundBase;
+class USoundConcurrency;
+
+// A few audio components reused for a sound played over and over by the same emitter (weapon shots), instead of a new
+// component per play. See UGCFXSubsystem::PlaySoundPooled
+USTRUCT()
+struct FPooledSoundEmitter
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TArray<UAudioComponent*> Voices;
+
+	int32 NextVoiceIndex = 0;
+};
+
+/**
+ * Single entry point for gameplay fx and one shot sounds. Niagara systems are spawned with auto release pooling,
+ * every spawn goes through per frame budget and distance culling. Counts and pool hit rate are in stat GCFX
+ */
+UCLASS()
+class GAMECODE_API UGCFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Return nullptr if the fx was culled or dropped by budget
+	UNiagaraComponent* SpawnNiagaraAtLocation(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+	// Legacy cascade content, goes through the same budget and cascade's own pool. Prefer niagara
+	UParticleSystemComponent* SpawnCascadeAtLocation(UParticleSystem* ParticleSystem, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+
+	void PlaySoundAtLocation(USoundBase* Sound, const FVector& Location);
+	void PlaySoundAttached(USoundBase* Sound, USceneComponent* AttachToComponent);
+	// Plays on a free voice of the emitter, adds one if there are less than MaxVoices or restarts the oldest one otherwise.
+	// Concurrency is for limits shared between emitters. Not played at all beyond gc.FX.CullDistance
+	void PlaySoundPooled(FPooledSoundEmitter& Emitter, USoundBase* Sound, USceneComponent* AttachToComponent, int32 MaxVoices,
+		USoundConcurrency* Concurrency = nullptr);
+	void ReleaseSoundEmitter(FPooledSoundEmitter& Emitter);
+
+	void PrewarmNiagara(UNiagaraSystem* System, int32 Count);
+
+private:
+	struct FNiagaraPoolUsage
+	{
+		int32 LiveCount = 0;
+		int32 AllocatedCount = 0;
+	};
+
+	bool CanSpawn(const FVector& Location);
+	bool IsWithinCullDistance(const FVector& Location) const;
+	void TrackNiagaraSpawn(UNiagaraComponent* Component, UNiagaraSystem* System);
+
+	UFUNCTION()
+	void OnNiagaraSystemFinished(UNiagaraComponent* Component);
+
+	TMap<TWeakObjectPtr<UNiagaraSystem>, FNiagaraPoolUsage> NiagaraPoolUsages;
+
+	uint64 LastSpawnFrame = 0;
+	int32 SpawnedThisFrame = 0;
+	int32 PoolHits = 0;
+	int32 PoolMisses = 0;
+};
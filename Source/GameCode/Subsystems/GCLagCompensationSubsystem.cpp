@@ -0,0 +1,466 @@
+#include "GCLagCompensationSubsystem.h"
+
+#include "GameCode.h"
+#include "Algo/StableSort.h"
+#include "Characters/GCBaseCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "PhysicsEngine/BodyInstance.h"
+
+DECLARE_STATS_GROUP(TEXT("GameCode Lag Compensation"), STATGROUP_GCLagCompensation, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Recorded characters"), STAT_GCLagCompCharacters, STATGROUP_GCLagCompensation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rewound traces"), STAT_GCLagCompTraces, STATGROUP_GCLagCompensation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rewound characters"), STAT_GCLagCompRewoundCharacters, STATGROUP_GCLagCompensation);
+
+static bool LagCompensationEnabled = true;
+static FAutoConsoleVariableRef CVarLagCompensationEnabled(
+	TEXT("gc.LagComp.Enabled"),
+	LagCompensationEnabled,
+	TEXT("Validate remote players' hitscan shots against characters rewound to the time the shot was made"));
+
+static float LagCompensationMaxRewindMs = 300.f;
+static FAutoConsoleVariableRef CVarLagCompensationMaxRewindMs(
+	TEXT("gc.LagComp.MaxRewindMs"),
+	LagCompensationMaxRewindMs,
+	TEXT("Shots are never rewound further than this. Players with higher ping have to lead their targets"));
+
+static float LagCompensationMaxRecordRate = 240.f;
+static FAutoConsoleVariableRef CVarLagCompensationMaxRecordRate(
+	TEXT("gc.LagComp.MaxRecordRate"),
+	LagCompensationMaxRecordRate,
+	TEXT("Characters are recorded at most this many times per second, so the history covers MaxRewindMs at any frame rate. ")
+	TEXT("Applied when the first character is registered"));
+
+namespace
+{
+	// Time along Start + Direction * Time, Time in [0, 1]. Segment starting inside the sphere hits at 0
+	bool SegmentSphereIntersection(const FVector& Start, const FVector& Direction, const FVector& Center, float Radius, float& OutTime)
+	{
+		const FVector CenterToStart = Start - Center;
+		const float A = Direction.SizeSquared();
+		const float B = 2.f * FVector::DotProduct(CenterToStart, Direction);
+		const float C = CenterToStart.SizeSquared() - Radius * Radius;
+		const float Discriminant = B * B - 4.f * A * C;
+		if (A < KINDA_SMALL_NUMBER || Discriminant < 0.f)
+		{
+			return false;
+		}
+
+		OutTime = FMath::Max((-B - FMath::Sqrt(Discriminant)) / (2.f * A), 0.f);
+		return OutTime <= 1.f && (-B + FMath::Sqrt(Discriminant)) >= 0.f;
+	}
+}
+
+void UGCLagCompensationSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_GCLagCompCharacters, Histories.Num());
+	Histories.Empty();
+	Super::Deinitialize();
+}
+
+void UGCLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	GC_TRACE_SCOPE(UGCLagCompensationSubsystem_RecordFrame);
+	RecordFrame();
+}
+
+bool UGCLagCompensationSubsystem::IsTickable() const
+{
+	return !IsTemplate() && LagCompensationEnabled && Histories.Num() > 0;
+}
+
+TStatId UGCLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void UGCLagCompensationSubsystem::RegisterCharacter(AGCBaseCharacter* Character)
+{
+	// nothing to compensate without remote players
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+	if (!IsValid(Character) || NetMode == NM_Standalone || NetMode == NM_Client)
+	{
+		return;
+	}
+
+	if (Histories.ContainsByPredicate([Character](const FHitboxHistory& History) { return History.Character == Character; }))
+	{
+		return;
+	}
+
+	GC_LLM_SCOPE(Characters);
+	if (Histories.Num() == 0)
+	{
+		// frames are recorded no more often than the record rate, so this many always span the max rewind
+		const float RecordRate = FMath::Max(LagCompensationMaxRecordRate, 1.f);
+		HistoryFramesCapacity = FMath::CeilToInt(LagCompensationMaxRewindMs * 0.001f * RecordRate) + 2;
+		FrameTimes.SetNumZeroed(HistoryFramesCapacity);
+		FrameHead = INDEX_NONE;
+		FramesCount = 0;
+	}
+
+	FHitboxHistory& History = Histories.AddDefaulted_GetRef();
+	History.Character = Character;
+	const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+	History.CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+	History.CapsuleHalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	for (const FHitboxSettings& Hitbox : Character->GetHitboxes())
+	{
+		const int32 BoneIndex = Character->GetMesh()->GetBoneIndex(Hitbox.BoneName);
+		if (BoneIndex != INDEX_NONE)
+		{
+			History.HitboxBones.Add(Hitbox.BoneName);
+			History.HitboxBoneIndices.Add(BoneIndex);
+			History.HitboxRadii.Add(Hitbox.Radius);
+		}
+	}
+
+	// frames recorded before the character appeared hold its spawn pose
+	const int32 HitboxesCount = History.HitboxBones.Num();
+	History.CapsuleLocations.Init(Capsule->GetComponentLocation(), HistoryFramesCapacity);
+	History.HitboxLocations.SetNumUninitialized(HistoryFramesCapacity * HitboxesCount);
+	for (int32 i = 0; i < HitboxesCount; ++i)
+	{
+		const FVector HitboxLocation = Character->GetMesh()->GetBoneTransform(History.HitboxBoneIndices[i]).GetLocation();
+		for (int32 Frame = 0; Frame < HistoryFramesCapacity; ++Frame)
+		{
+			History.HitboxLocations[Frame * HitboxesCount + i] = HitboxLocation;
+		}
+	}
+
+	const FBox SpawnBounds = ComputeFrameBounds(History, 0);
+	History.FrameBounds.Init(SpawnBounds, HistoryFramesCapacity);
+	History.HistoryBounds = SpawnBounds;
+	INC_DWORD_STAT(STAT_GCLagCompCharacters);
+}
+
+void UGCLagCompensationSubsystem::UnregisterCharacter(AGCBaseCharacter* Character)
+{
+	const int32 RemovedCount = Histories.RemoveAllSwap([Character](const FHitboxHistory& History) { return History.Character == Character; });
+	DEC_DWORD_STAT_BY(STAT_GCLagCompCharacters, RemovedCount);
+}
+
+float UGCLagCompensationSubsystem::GetShotTime(const AController* ShooterController) const
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	const APlayerController* PlayerController = Cast<APlayerController>(ShooterController);
+	if (!LagCompensationEnabled || !IsValid(PlayerController) || PlayerController->IsLocalController() || !IsValid(PlayerController->PlayerState))
+	{
+		return CurrentTime;
+	}
+
+	// the client saw the world half a round trip ago and the shot took another half to get here
+	const float Latency = FMath::Min(PlayerController->PlayerState->ExactPing, LagCompensationMaxRewindMs) * 0.001f;
+	return CurrentTime - Latency;
+}
+
+float UGCLagCompensationSubsystem::ClampShotTime(float ShooterTime) const
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (!LagCompensationEnabled)
+	{
+		return CurrentTime;
+	}
+	
+	return FMath::Clamp(ShooterTime, CurrentTime - LagCompensationMaxRewindMs * 0.001f, CurrentTime);
+}
+
+bool UGCLagCompensationSubsystem::LineTraceRewound(float ShotTime, FHitResult& OutHit, const FVector& Start, const FVector& End,
+	ECollisionChannel TraceChannel, const FCollisionQueryParams& Params) const
+{
+	const UWorld* World = GetWorld();
+	int32 OlderFrame = INDEX_NONE;
+	int32 NewerFrame = INDEX_NONE;
+	float Alpha = 0.f;
+	if (!LagCompensationEnabled || Histories.Num() == 0 || !FindFrames(ShotTime, OlderFrame, NewerFrame, Alpha))
+	{
+		return World->LineTraceSingleByChannel(OutHit, Start, End, TraceChannel, Params);
+	}
+
+	GC_TRACE_SCOPE(UGCLagCompensationSubsystem_LineTraceRewound);
+	INC_DWORD_STAT(STAT_GCLagCompTraces);
+	FRewindCandidates Candidates;
+	FCollisionQueryParams WorldParams = Params;
+	GatherCandidates(Start, End, TraceChannel, Candidates, WorldParams);
+
+	// the rest of the world is tested as it is now
+	FHitResult WorldHit;
+	const bool bWorldHit = World->LineTraceSingleByChannel(WorldHit, Start, End, TraceChannel, WorldParams);
+	float HitTime = bWorldHit ? WorldHit.Time : 1.f;
+	bool bCharacterHit = false;
+	for (const FHitboxHistory* History : Candidates)
+	{
+		INC_DWORD_STAT(STAT_GCLagCompRewoundCharacters);
+		bCharacterHit |= TraceHistory(*History, OlderFrame, NewerFrame, Alpha, Start, End, HitTime, OutHit);
+	}
+
+	if (bCharacterHit)
+	{
+		if (Params.bReturnPhysicalMaterial)
+		{
+			SetPhysicalMaterial(OutHit);
+		}
+
+		return true;
+	}
+
+	OutHit = WorldHit;
+	return bWorldHit;
+}
+
+void UGCLagCompensationSubsystem::LineTraceMultiRewound(float ShotTime, TArray<FHitResult>& OutHits, const FVector& Start,
+	const FVector& End, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParams) const
+{
+	const UWorld* World = GetWorld();
+	int32 OlderFrame = INDEX_NONE;
+	int32 NewerFrame = INDEX_NONE;
+	float Alpha = 0.f;
+	if (!LagCompensationEnabled || Histories.Num() == 0 || !FindFrames(ShotTime, OlderFrame, NewerFrame, Alpha))
+	{
+		World->LineTraceMultiByChannel(OutHits, Start, End, TraceChannel, Params, ResponseParams);
+		return;
+	}
+
+	GC_TRACE_SCOPE(UGCLagCompensationSubsystem_LineTraceMultiRewound);
+	INC_DWORD_STAT(STAT_GCLagCompTraces);
+	FRewindCandidates Candidates;
+	FCollisionQueryParams WorldParams = Params;
+	GatherCandidates(Start, End, TraceChannel, Candidates, WorldParams);
+	World->LineTraceMultiByChannel(OutHits, Start, End, TraceChannel, WorldParams, ResponseParams);
+	
+	// the first hit on every rewound character, in distance order with the world hits
+	bool bCharacterHit = false;
+	for (const FHitboxHistory* History : Candidates)
+	{
+		INC_DWORD_STAT(STAT_GCLagCompRewoundCharacters);
+		float HitTime = 1.f;
+		FHitResult CharacterHit;
+		if (TraceHistory(*History, OlderFrame, NewerFrame, Alpha, Start, End, HitTime, CharacterHit))
+		{
+			if (Params.bReturnPhysicalMaterial)
+			{
+				SetPhysicalMaterial(CharacterHit);
+			}
+			
+			OutHits.Add(CharacterHit);
+			bCharacterHit = true;
+		}
+	}
+
+	if (bCharacterHit)
+	{
+		Algo::StableSortBy(OutHits, &FHitResult::Time);
+	}
+}
+
+void UGCLagCompensationSubsystem::GatherCandidates(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	FRewindCandidates& OutCandidates, FCollisionQueryParams& InOutWorldParams) const
+{
+	// broad phase: only characters that were anywhere near the ray during the whole history are rewound
+	const FVector StartToEnd = End - Start;
+	const FVector OneOverStartToEnd = StartToEnd.Reciprocal();
+	for (const FHitboxHistory& History : Histories)
+	{
+		const AGCBaseCharacter* Character = History.Character.Get();
+		if (!IsValid(Character) || InOutWorldParams.GetIgnoredActors().Contains(Character->GetUniqueID())
+			|| (Character->GetMesh()->GetCollisionResponseToChannel(TraceChannel) != ECR_Block
+				&& Character->GetCapsuleComponent()->GetCollisionResponseToChannel(TraceChannel) != ECR_Block)
+			|| !FMath::LineBoxIntersection(History.HistoryBounds, Start, End, StartToEnd, OneOverStartToEnd))
+		{
+			continue;
+		}
+
+		OutCandidates.Add(&History);
+		InOutWorldParams.AddIgnoredActor(Character);
+	}
+}
+
+void UGCLagCompensationSubsystem::SetPhysicalMaterial(FHitResult& Hit)
+{
+	if (Hit.Component.IsValid())
+	{
+		const FBodyInstance* BodyInstance = Hit.Component->GetBodyInstance(Hit.BoneName);
+		Hit.PhysMaterial = BodyInstance != nullptr ? BodyInstance->GetSimplePhysicalMaterial() : nullptr;
+	}
+}
+
+void UGCLagCompensationSubsystem::RecordFrame()
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (FramesCount > 0 && CurrentTime - FrameTimes[FrameHead] < 1.f / FMath::Max(LagCompensationMaxRecordRate, 1.f))
+	{
+		return;
+	}
+	
+	FrameHead = (FrameHead + 1) % HistoryFramesCapacity;
+	FramesCount = FMath::Min(FramesCount + 1, HistoryFramesCapacity);
+	FrameTimes[FrameHead] = CurrentTime;
+
+	for (int32 i = Histories.Num() - 1; i >= 0; --i)
+	{
+		FHitboxHistory& History = Histories[i];
+		const AGCBaseCharacter* Character = History.Character.Get();
+		if (!IsValid(Character))
+		{
+			Histories.RemoveAtSwap(i);
+			DEC_DWORD_STAT(STAT_GCLagCompCharacters);
+			continue;
+		}
+
+		History.CapsuleLocations[FrameHead] = Character->GetCapsuleComponent()->GetComponentLocation();
+		const USkeletalMeshComponent* Mesh = Character->GetMesh();
+		const FTransform& MeshTransform = Mesh->GetComponentTransform();
+		const int32 HitboxesCount = History.HitboxBones.Num();
+		FVector* FrameHitboxes = History.HitboxLocations.GetData() + FrameHead * HitboxesCount;
+		for (int32 Hitbox = 0; Hitbox < HitboxesCount; ++Hitbox)
+		{
+			FrameHitboxes[Hitbox] = Mesh->GetBoneTransform(History.HitboxBoneIndices[Hitbox], MeshTransform).GetLocation();
+		}
+
+		UpdateHistoryBounds(History, FrameHead);
+	}
+}
+
+FBox UGCLagCompensationSubsystem::ComputeFrameBounds(const FHitboxHistory& History, int32 Frame)
+{
+	const FVector CapsuleExtent(History.CapsuleRadius, History.CapsuleRadius, History.CapsuleHalfHeight);
+	const FVector& CapsuleLocation = History.CapsuleLocations[Frame];
+	FBox Bounds(CapsuleLocation - CapsuleExtent, CapsuleLocation + CapsuleExtent);
+	const int32 HitboxesCount = History.HitboxBones.Num();
+	for (int32 Hitbox = 0; Hitbox < HitboxesCount; ++Hitbox)
+	{
+		// hands and heads tend to stick out of the capsule
+		const FVector& HitboxLocation = History.HitboxLocations[Frame * HitboxesCount + Hitbox];
+		Bounds += FBox::BuildAABB(HitboxLocation, FVector(History.HitboxRadii[Hitbox]));
+	}
+
+	return Bounds;
+}
+
+void UGCLagCompensationSubsystem::UpdateHistoryBounds(FHitboxHistory& History, int32 Frame) const
+{
+	const FBox OverwrittenBounds = History.FrameBounds[Frame];
+	const FBox NewBounds = ComputeFrameBounds(History, Frame);
+	History.FrameBounds[Frame] = NewBounds;
+
+	// bounds only shrink if the overwritten frame was on their edge, otherwise the new frame just grows them
+	const FBox& Bounds = History.HistoryBounds;
+	const bool bOverwrittenOnEdge = OverwrittenBounds.Min.X <= Bounds.Min.X || OverwrittenBounds.Min.Y <= Bounds.Min.Y
+		|| OverwrittenBounds.Min.Z <= Bounds.Min.Z || OverwrittenBounds.Max.X >= Bounds.Max.X || OverwrittenBounds.Max.Y >= Bounds.Max.Y
+		|| OverwrittenBounds.Max.Z >= Bounds.Max.Z;
+	if (!bOverwrittenOnEdge)
+	{
+		History.HistoryBounds += NewBounds;
+		return;
+	}
+
+	History.HistoryBounds.Init();
+	for (const FBox& FrameBounds : History.FrameBounds)
+	{
+		History.HistoryBounds += FrameBounds;
+	}
+}
+
+bool UGCLagCompensationSubsystem::FindFrames(float ShotTime, int32& OutOlderFrame, int32& OutNewerFrame, float& OutAlpha) const
+{
+	if (FramesCount == 0 || ShotTime >= FrameTimes[FrameHead])
+	{
+		return false;
+	}
+
+	ShotTime = FMath::Max(ShotTime, FrameTimes[FrameHead] - LagCompensationMaxRewindMs * 0.001f);
+	OutNewerFrame = FrameHead;
+	for (int32 Age = 1; Age < FramesCount; ++Age)
+	{
+		OutOlderFrame = GetFrameIndex(Age);
+		const float OlderTime = FrameTimes[OutOlderFrame];
+		if (OlderTime <= ShotTime)
+		{
+			const float NewerTime = FrameTimes[OutNewerFrame];
+			OutAlpha = NewerTime > OlderTime ? (ShotTime - OlderTime) / (NewerTime - OlderTime) : 1.f;
+			return true;
+		}
+
+		OutNewerFrame = OutOlderFrame;
+	}
+
+	// shot is older than the history, use the oldest frame
+	OutOlderFrame = OutNewerFrame;
+	OutAlpha = 0.f;
+	return true;
+}
+
+bool UGCLagCompensationSubsystem::TraceHistory(const FHitboxHistory& History, int32 OlderFrame, int32 NewerFrame, float Alpha,
+	const FVector& Start, const FVector& End, float& InOutHitTime, FHitResult& OutHit) const
+{
+	const FVector Direction = End - Start;
+	const int32 HitboxesCount = History.HitboxBones.Num();
+	int32 HitHitbox = INDEX_NONE;
+	float HitTime = InOutHitTime;
+	FVector HitNormal = FVector::ZeroVector;
+	if (HitboxesCount > 0)
+	{
+		const FVector* OlderHitboxes = History.HitboxLocations.GetData() + OlderFrame * HitboxesCount;
+		const FVector* NewerHitboxes = History.HitboxLocations.GetData() + NewerFrame * HitboxesCount;
+		for (int32 Hitbox = 0; Hitbox < HitboxesCount; ++Hitbox)
+		{
+			const FVector Center = FMath::Lerp(OlderHitboxes[Hitbox], NewerHitboxes[Hitbox], Alpha);
+			float Time = 0.f;
+			if (SegmentSphereIntersection(Start, Direction, Center, History.HitboxRadii[Hitbox], Time) && Time < HitTime)
+			{
+				HitTime = Time;
+				HitHitbox = Hitbox;
+				HitNormal = (Start + Direction * Time - Center).GetSafeNormal();
+			}
+		}
+	}
+	else
+	{
+		// no hitboxes configured, fall back to the upright capsule
+		const FVector CapsuleLocation = FMath::Lerp(History.CapsuleLocations[OlderFrame], History.CapsuleLocations[NewerFrame], Alpha);
+		const FVector CapsuleAxis(0.f, 0.f, FMath::Max(History.CapsuleHalfHeight - History.CapsuleRadius, 0.f));
+		FVector RayPoint;
+		FVector AxisPoint;
+		FMath::SegmentDistToSegmentSafe(Start, End, CapsuleLocation - CapsuleAxis, CapsuleLocation + CapsuleAxis, RayPoint, AxisPoint);
+		float Time = 0.f;
+		if (SegmentSphereIntersection(Start, Direction, AxisPoint, History.CapsuleRadius, Time) && Time < HitTime)
+		{
+			HitTime = Time;
+			HitNormal = (Start + Direction * Time - AxisPoint).GetSafeNormal();
+		}
+	}
+
+	if (HitTime >= InOutHitTime)
+	{
+		return false;
+	}
+
+	AGCBaseCharacter* Character = History.Character.Get();
+	InOutHitTime = HitTime;
+	OutHit = FHitResult(Start, End);
+	OutHit.bBlockingHit = true;
+	OutHit.Time = HitTime;
+	OutHit.Distance = Direction.Size() * HitTime;
+	OutHit.Location = OutHit.ImpactPoint = Start + Direction * HitTime;
+	OutHit.Normal = OutHit.ImpactNormal = HitNormal;
+	OutHit.Actor = Character;
+	if (HitHitbox != INDEX_NONE)
+	{
+		OutHit.Component = Character->GetMesh();
+		OutHit.BoneName = History.HitboxBones[HitHitbox];
+	}
+	else
+	{
+		OutHit.Component = Character->GetCapsuleComponent();
+	}
+
+	return true;
+}
+
+int32 UGCLagCompensationSubsystem::GetFrameIndex(int32 Age) const
+{
+	return (FrameHead - Age + HistoryFramesCapacity) % HistoryFramesCapacity;
+}
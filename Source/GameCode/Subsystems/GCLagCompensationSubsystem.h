@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Tickable.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCLagCompensationSubsystem.generated.h"
+
+class AGCBaseCharacter;
+
+/**
+ * Server side hitbox history for lag compensated hitscan. Records capsules and bone hitboxes of registered characters
+ * every frame for the last gc.LagComp.MaxRewindMs and traces shots against the state interpolated to the shooter's time.
+ * Only characters whose whole history box is crossed by the shot are rewound
+ */
+UCLASS()
+class GAMECODE_API UGCLagCompensationSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(AGCBaseCharacter* Character);
+	void UnregisterCharacter(AGCBaseCharacter* Character);
+
+	// World time the shooter saw when shooting. Current time for local and AI shooters
+	float GetShotTime(const AController* ShooterController) const;
+	// Time reported by the shooter, limited to gc.LagComp.MaxRewindMs into the past and never ahead of the server
+	float ClampShotTime(float ShooterTime) const;
+
+	// Line trace where registered characters are tested in their state at ShotTime, everything else in the current state
+	bool LineTraceRewound(float ShotTime, FHitResult& OutHit, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+		const FCollisionQueryParams& Params) const;
+	// Same for multi traces. Rewound characters report their first hit only
+	void LineTraceMultiRewound(float ShotTime, TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End,
+		ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
+		const FCollisionResponseParams& ResponseParams = FCollisionResponseParams::DefaultResponseParam) const;
+
+private:
+	struct FHitboxHistory
+	{
+		TWeakObjectPtr<AGCBaseCharacter> Character;
+		float CapsuleRadius = 0.f;
+		float CapsuleHalfHeight = 0.f;
+		TArray<FName, TInlineAllocator<8>> HitboxBones;
+		// resolved once on register, names are for hit results only
+		TArray<int32, TInlineAllocator<8>> HitboxBoneIndices;
+		TArray<float, TInlineAllocator<8>> HitboxRadii;
+
+		// [Frame]
+		TArray<FVector> CapsuleLocations;
+		// [Frame * HitboxesCount + Hitbox]
+		TArray<FVector> HitboxLocations;
+		// [Frame] capsule and hitboxes of one frame
+		TArray<FBox> FrameBounds;
+		// union of FrameBounds, for broad phase
+		FBox HistoryBounds = FBox(ForceInit);
+	};
+
+	using FRewindCandidates = TArray<const FHitboxHistory*, TInlineAllocator<8>>;
+	
+	// Characters to rewind are added to OutCandidates and ignored by InOutWorldParams
+	void GatherCandidates(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, FRewindCandidates& OutCandidates,
+		FCollisionQueryParams& InOutWorldParams) const;
+	static void SetPhysicalMaterial(FHitResult& Hit);
+	void RecordFrame();
+	static FBox ComputeFrameBounds(const FHitboxHistory& History, int32 Frame);
+	// Frame was just recorded over an older one
+	void UpdateHistoryBounds(FHitboxHistory& History, int32 Frame) const;
+	bool FindFrames(float ShotTime, int32& OutOlderFrame, int32& OutNewerFrame, float& OutAlpha) const;
+	bool TraceHistory(const FHitboxHistory& History, int32 OlderFrame, int32 NewerFrame, float Alpha, const FVector& Start,
+		const FVector& End, float& InOutHitTime, FHitResult& OutHit) const;
+
+	int32 GetFrameIndex(int32 Age) const;
+
+	TArray<FHitboxHistory> Histories;
+	// ring of frame timestamps shared by all histories
+	TArray<float> FrameTimes;
+	int32 HistoryFramesCapacity = 0;
+	int32 FrameHead = INDEX_NONE;
+	int32 FramesCount = 0;
+};
@@ -0,0 +1,116 @@
+#include "GCProjectilePoolSubsystem.h"
+
+#include "GameCode.h"
+#include "Actors/Projectiles/GCProjectile.h"
+
+TRACE_DECLARE_INT_COUNTER(GCProjectileSpawns, TEXT("GameCode/Projectile spawns"));
+TRACE_DECLARE_INT_COUNTER(GCPooledProjectiles, TEXT("GameCode/Pooled projectiles"));
+
+static int32 ProjectilePoolEnabled = 1;
+static FAutoConsoleVariableRef CVarProjectilePoolEnabled(
+	TEXT("gc.ProjectilePool.Enabled"),
+	ProjectilePoolEnabled,
+	TEXT("0 - projectiles are spawned and destroyed every shot, 1 - projectiles are pooled per class"));
+
+static int32 ProjectilePoolMaxPerClass = 64;
+static FAutoConsoleVariableRef CVarProjectilePoolMaxPerClass(
+	TEXT("gc.ProjectilePool.MaxPerClass"),
+	ProjectilePoolMaxPerClass,
+	TEXT("Max amount of free projectiles kept per class. Released projectiles above it are destroyed"));
+
+void UGCProjectilePoolSubsystem::Deinitialize()
+{
+	Pools.Empty();
+	Super::Deinitialize();
+}
+
+AGCProjectile* UGCProjectilePoolSubsystem::AcquireProjectile(const TSubclassOf<AGCProjectile>& ProjectileClass,
+	const FTransform& Transform, AActor* Owner)
+{
+	GC_TRACE_SCOPE(UGCProjectilePoolSubsystem_AcquireProjectile);
+	if (!ProjectilePoolEnabled)
+	{
+		return SpawnProjectile(ProjectileClass, Transform, Owner);
+	}
+
+	FProjectilePool* Pool = Pools.Find(ProjectileClass);
+	while (Pool != nullptr && Pool->FreeProjectiles.Num() > 0)
+	{
+		AGCProjectile* Projectile = Pool->FreeProjectiles.Pop(false);
+		// pooled projectile could still be destroyed by someone else, e.g. from blueprint
+		if (IsValid(Projectile))
+		{
+			TRACE_COUNTER_DECREMENT(GCPooledProjectiles);
+			Projectile->SetActorLocationAndRotation(Transform.GetLocation(), Transform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+			Projectile->SetOwner(Owner);
+			Projectile->OnAcquiredFromPool();
+			return Projectile;
+		}
+	}
+
+	AGCProjectile* Projectile = SpawnProjectile(ProjectileClass, Transform, Owner);
+	if (IsValid(Projectile))
+	{
+		Projectile->SetPooled(true);
+	}
+
+	return Projectile;
+}
+
+void UGCProjectilePoolSubsystem::ReleaseProjectile(AGCProjectile* Projectile)
+{
+	if (!IsValid(Projectile))
+	{
+		return;
+	}
+
+	FProjectilePool& Pool = Pools.FindOrAdd(Projectile->GetClass());
+	if (!ProjectilePoolEnabled || Pool.FreeProjectiles.Num() >= ProjectilePoolMaxPerClass)
+	{
+		Projectile->SetPooled(false);
+		Projectile->Destroy();
+		return;
+	}
+
+	Projectile->OnReleasedToPool();
+	Pool.FreeProjectiles.Add(Projectile);
+	TRACE_COUNTER_INCREMENT(GCPooledProjectiles);
+}
+
+void UGCProjectilePoolSubsystem::Prewarm(const TSubclassOf<AGCProjectile>& ProjectileClass, int32 Count)
+{
+	if (!ProjectilePoolEnabled || !IsValid(ProjectileClass))
+	{
+		return;
+	}
+
+	GC_TRACE_SCOPE(UGCProjectilePoolSubsystem_Prewarm);
+	const int32 MissingCount = FMath::Min(Count, ProjectilePoolMaxPerClass) - GetFreeCount(ProjectileClass);
+	for (int32 i = 0; i < MissingCount; ++i)
+	{
+		AGCProjectile* Projectile = SpawnProjectile(ProjectileClass, FTransform::Identity, nullptr);
+		if (IsValid(Projectile))
+		{
+			Projectile->SetPooled(true);
+			ReleaseProjectile(Projectile);
+		}
+	}
+}
+
+int32 UGCProjectilePoolSubsystem::GetFreeCount(const TSubclassOf<AGCProjectile>& ProjectileClass) const
+{
+	const FProjectilePool* Pool = Pools.Find(ProjectileClass);
+	return Pool != nullptr ? Pool->FreeProjectiles.Num() : 0;
+}
+
+AGCProjectile* UGCProjectilePoolSubsystem::SpawnProjectile(const TSubclassOf<AGCProjectile>& ProjectileClass,
+	const FTransform& Transform, AActor* Owner)
+{
+	GC_TRACE_SCOPE(UGCProjectilePoolSubsystem_SpawnProjectile);
+	GC_LLM_SCOPE(Projectiles);
+	TRACE_COUNTER_INCREMENT(GCProjectileSpawns);
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = Owner;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AGCProjectile>(ProjectileClass, Transform, SpawnParameters);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCProjectilePoolSubsystem.generated.h"
+
+class AGCProjectile;
+
+USTRUCT()
+struct FProjectilePool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AGCProjectile*> FreeProjectiles;
+};
+
+/**
+ * Per class pools of projectiles. Pooled projectiles are deactivated instead of destroyed and reset when acquired again.
+ * gc.ProjectilePool.Enabled 0 falls back to SpawnActor/Destroy so both paths can be profiled
+ */
+UCLASS()
+class GAMECODE_API UGCProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	AGCProjectile* AcquireProjectile(const TSubclassOf<AGCProjectile>& ProjectileClass, const FTransform& Transform, AActor* Owner);
+	void ReleaseProjectile(AGCProjectile* Projectile);
+	void Prewarm(const TSubclassOf<AGCProjectile>& ProjectileClass, int32 Count);
+
+	int32 GetFreeCount(const TSubclassOf<AGCProjectile>& ProjectileClass) const;
+
+private:
+	AGCProjectile* SpawnProjectile(const TSubclassOf<AGCProjectile>& ProjectileClass, const FTransform& Transform, AActor* Owner);
+
+	UPROPERTY()
+	TMap<TSubclassOf<AGCProjectile>, FProjectilePool> Pools;
+};
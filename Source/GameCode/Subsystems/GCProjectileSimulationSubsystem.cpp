@@ -0,0 +1,234 @@
+#include "GCProjectileSimulationSubsystem.h"
+
+#include "GameCode.h"
+#include "Async/ParallelFor.h"
+#include "Components/Combat/BarrelComponent.h"
+
+TRACE_DECLARE_INT_COUNTER(GCSimulatedProjectiles, TEXT("GameCode/Simulated projectiles"));
+
+static int32 MaxSimulatedProjectiles = 8192;
+static FAutoConsoleVariableRef CVarMaxSimulatedProjectiles(
+	TEXT("gc.ProjectileSim.MaxProjectiles"),
+	MaxSimulatedProjectiles,
+	TEXT("Max amount of simulated projectiles in flight. New projectiles above it are dropped"));
+
+static int32 SimulatedProjectilesChunkSize = 256;
+static FAutoConsoleVariableRef CVarSimulatedProjectilesChunkSize(
+	TEXT("gc.ProjectileSim.ChunkSize"),
+	SimulatedProjectilesChunkSize,
+	TEXT("Amount of projectiles integrated by one ParallelFor task"));
+
+namespace
+{
+	struct FSimulatedProjectileHit
+	{
+		TWeakObjectPtr<UBarrelComponent> Barrel;
+		FHitResult Hit;
+		FVector Direction;
+	};
+}
+
+void UGCProjectileSimulationSubsystem::Deinitialize()
+{
+	TRACE_COUNTER_SUBTRACT(GCSimulatedProjectiles, Positions.Num());
+	Positions.Empty();
+	Velocities.Empty();
+	SweepStarts.Empty();
+	GravityScales.Empty();
+	Distances.Empty();
+	MaxRanges.Empty();
+	TimeOffsets.Empty();
+	SweepsResolved.Empty();
+	Radii.Empty();
+	SweepHandles.Empty();
+	Barrels.Empty();
+	Owners.Empty();
+	OwnerQueryParams.Empty();
+	Super::Deinitialize();
+}
+
+void UGCProjectileSimulationSubsystem::Tick(float DeltaTime)
+{
+	GC_TRACE_SCOPE(UGCProjectileSimulationSubsystem_Tick);
+	ProcessSweepResults();
+	Integrate(DeltaTime);
+	IssueSweeps();
+}
+
+bool UGCProjectileSimulationSubsystem::IsTickable() const
+{
+	return !IsTemplate() && Positions.Num() > 0;
+}
+
+TStatId UGCProjectileSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCProjectileSimulationSubsystem, STATGROUP_Tickables);
+}
+
+void UGCProjectileSimulationSubsystem::AddProjectile(const FVector& Location, const FVector& Velocity, float GravityScale,
+	float Radius, float MaxRange, UBarrelComponent* Barrel, AActor* Owner, float TimeOffset)
+{
+	if (Positions.Num() >= MaxSimulatedProjectiles)
+	{
+		return;
+	}
+
+	TRACE_COUNTER_INCREMENT(GCSimulatedProjectiles);
+	Positions.Add(Location);
+	Velocities.Add(Velocity);
+	SweepStarts.Add(Location);
+	GravityScales.Add(GravityScale);
+	Distances.Add(0.f);
+	MaxRanges.Add(MaxRange);
+	TimeOffsets.Add(FMath::Max(TimeOffset, 0.f));
+	SweepsResolved.Add(true);
+	Radii.Add(Radius);
+	SweepHandles.AddDefaulted();
+	Barrels.Add(Barrel);
+	Owners.Add(Owner);
+}
+
+void UGCProjectileSimulationSubsystem::ProcessSweepResults()
+{
+	GC_TRACE_SCOPE(UGCProjectileSimulationSubsystem_ProcessSweepResults);
+	UWorld* World = GetWorld();
+	TArray<FSimulatedProjectileHit, TInlineAllocator<32>> Hits;
+	for (int32 i = Positions.Num() - 1; i >= 0; --i)
+	{
+		FTraceDatum SweepDatum;
+		// a sweep without results yet keeps its segment, the next sweep covers it again from the same start
+		SweepsResolved[i] = !SweepHandles[i].IsValid() || World->QueryTraceData(SweepHandles[i], SweepDatum);
+		if (SweepHandles[i].IsValid() && SweepsResolved[i])
+		{
+			const FHitResult* BlockingHit = SweepDatum.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+			if (BlockingHit != nullptr)
+			{
+				FSimulatedProjectileHit& ProjectileHit = Hits.AddDefaulted_GetRef();
+				ProjectileHit.Barrel = Barrels[i];
+				ProjectileHit.Hit = *BlockingHit;
+				// damage falloff expects distance from the muzzle, not from the start of the last segment
+				ProjectileHit.Hit.Distance += Distances[i];
+				ProjectileHit.Direction = Velocities[i].GetSafeNormal();
+				RemoveProjectile(i);
+				continue;
+			}
+		}
+
+		if (Distances[i] >= MaxRanges[i] || !Barrels[i].IsValid())
+		{
+			RemoveProjectile(i);
+		}
+	}
+
+	// barrels are notified after the arrays are compacted, so they are free to fire new projectiles from the callback
+	for (const FSimulatedProjectileHit& ProjectileHit : Hits)
+	{
+		if (ProjectileHit.Barrel.IsValid())
+		{
+			ProjectileHit.Barrel->OnProjectileHit(ProjectileHit.Hit, ProjectileHit.Direction);
+		}
+	}
+}
+
+void UGCProjectileSimulationSubsystem::Integrate(float DeltaTime)
+{
+	GC_TRACE_SCOPE(UGCProjectileSimulationSubsystem_Integrate);
+	const int32 Count = Positions.Num();
+	const int32 ChunkSize = FMath::Max(SimulatedProjectilesChunkSize, 1);
+	const int32 ChunksCount = FMath::DivideAndRoundUp(Count, ChunkSize);
+	const FVector Gravity = FVector(0.f, 0.f, GetWorld()->GetGravityZ());
+
+	FVector* PositionsData = Positions.GetData();
+	FVector* VelocitiesData = Velocities.GetData();
+	FVector* SweepStartsData = SweepStarts.GetData();
+	const float* GravityScalesData = GravityScales.GetData();
+	float* DistancesData = Distances.GetData();
+	float* TimeOffsetsData = TimeOffsets.GetData();
+	const bool* SweepsResolvedData = SweepsResolved.GetData();
+
+	ParallelFor(ChunksCount, [=](int32 ChunkIndex)
+	{
+		const int32 End = FMath::Min(Count, (ChunkIndex + 1) * ChunkSize);
+		for (int32 i = ChunkIndex * ChunkSize; i < End; ++i)
+		{
+			// last segment is done, its sweep result was processed already
+			if (SweepsResolvedData[i])
+			{
+				DistancesData[i] += FVector::Dist(SweepStartsData[i], PositionsData[i]);
+				SweepStartsData[i] = PositionsData[i];
+			}
+
+			const FVector Acceleration = Gravity * GravityScalesData[i];
+			const float StepTime = DeltaTime + TimeOffsetsData[i];
+			TimeOffsetsData[i] = 0.f;
+			PositionsData[i] += (VelocitiesData[i] + 0.5f * Acceleration * StepTime) * StepTime;
+			VelocitiesData[i] += Acceleration * StepTime;
+		}
+	}, ChunksCount < 2);
+}
+
+void UGCProjectileSimulationSubsystem::IssueSweeps()
+{
+	GC_TRACE_SCOPE(UGCProjectileSimulationSubsystem_IssueSweeps);
+	UWorld* World = GetWorld();
+	const int32 Count = Positions.Num();
+	GC_COUNT_TRACES(Count);
+	for (auto It = OwnerQueryParams.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// rounds of one shooter usually follow each other, its params are looked up once per run of them
+	const AActor* CurrentOwner = nullptr;
+	const FCollisionQueryParams* QueryParams = &SweepQueryParams;
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const AActor* Owner = Owners[i].Get();
+		if (Owner != CurrentOwner)
+		{
+			CurrentOwner = Owner;
+			QueryParams = &GetSweepQueryParams(Owner);
+		}
+
+		SweepHandles[i] = Radii[i] > 0.f
+			? World->AsyncSweepByChannel(EAsyncTraceType::Single, SweepStarts[i], Positions[i], FQuat::Identity, ECC_Bullet,
+				FCollisionShape::MakeSphere(Radii[i]), *QueryParams)
+			: World->AsyncLineTraceByChannel(EAsyncTraceType::Single, SweepStarts[i], Positions[i], ECC_Bullet, *QueryParams);
+	}
+}
+
+const FCollisionQueryParams& UGCProjectileSimulationSubsystem::GetSweepQueryParams(const AActor* Owner)
+{
+	if (!IsValid(Owner))
+	{
+		return SweepQueryParams;
+	}
+
+	GCTraceUtils::FOwnerChainQueryParams* Params = OwnerQueryParams.Find(Owner);
+	if (Params == nullptr)
+	{
+		Params = &OwnerQueryParams.Add(Owner, GCTraceUtils::FOwnerChainQueryParams(FName("SimulatedProjectile")));
+	}
+
+	return Params->Get(Owner);
+}
+
+void UGCProjectileSimulationSubsystem::RemoveProjectile(int32 Index)
+{
+	TRACE_COUNTER_DECREMENT(GCSimulatedProjectiles);
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	SweepStarts.RemoveAtSwap(Index, 1, false);
+	GravityScales.RemoveAtSwap(Index, 1, false);
+	Distances.RemoveAtSwap(Index, 1, false);
+	MaxRanges.RemoveAtSwap(Index, 1, false);
+	TimeOffsets.RemoveAtSwap(Index, 1, false);
+	SweepsResolved.RemoveAtSwap(Index, 1, false);
+	Radii.RemoveAtSwap(Index, 1, false);
+	SweepHandles.RemoveAtSwap(Index, 1, false);
+	Barrels.RemoveAtSwap(Index, 1, false);
+	Owners.RemoveAtSwap(Index, 1, false);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Utils/GCTraceUtils.h"
+#include "GCProjectileSimulationSubsystem.generated.h"
+
+class UBarrelComponent;
+
+/**
+ * Actorless projectiles for fast rounds (minigun, turrets). Rounds are stored as structure of arrays, integrated in
+ * ParallelFor and swept with one async sweep per round per frame. Hits are reported back to the barrel that fired them
+ * on the next frame, when the sweep results are ready
+ */
+UCLASS()
+class GAMECODE_API UGCProjectileSimulationSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	// TimeOffset - how long before the end of the frame the projectile was fired, added to its first integration step
+	void AddProjectile(const FVector& Location, const FVector& Velocity, float GravityScale, float Radius, float MaxRange,
+		UBarrelComponent* Barrel, AActor* Owner, float TimeOffset = 0.f);
+
+	int32 GetProjectilesCount() const { return Positions.Num(); }
+
+private:
+	void ProcessSweepResults();
+	void Integrate(float DeltaTime);
+	void IssueSweeps();
+	void RemoveProjectile(int32 Index);
+
+	// hot data, touched by integration
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<FVector> SweepStarts;
+	TArray<float> GravityScales;
+	TArray<float> Distances;
+	TArray<float> MaxRanges;
+	TArray<float> TimeOffsets;
+	// the last sweep result was processed, so the segment it covered is done
+	TArray<bool> SweepsResolved;
+
+	// cold data, touched only when sweeping or on hit
+	TArray<float> Radii;
+	TArray<FTraceHandle> SweepHandles;
+	TArray<TWeakObjectPtr<UBarrelComponent>> Barrels;
+	TArray<TWeakObjectPtr<AActor>> Owners;
+
+	const FCollisionQueryParams& GetSweepQueryParams(const AActor* Owner);
+
+	// owner chains of the shooters, rebuilt only when a chain changes
+	TMap<TWeakObjectPtr<const AActor>, GCTraceUtils::FOwnerChainQueryParams> OwnerQueryParams;
+	FCollisionQueryParams SweepQueryParams = FCollisionQueryParams(FName("SimulatedProjectile"));
+};
@@ -0,0 +1,422 @@
+#include "GCRadialDamageSubsystem.h"
+
+#include "GameCode.h"
+#include "Async/ParallelFor.h"
+#include "GCFXSubsystem.h"
+#include "NiagaraSystem.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
+
+DECLARE_STATS_GROUP(TEXT("GameCode Radial Damage"), STATGROUP_GCRadialDamage, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Damageable actors"), STAT_GCRadialDamageActors, STATGROUP_GCRadialDamage);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosions"), STAT_GCRadialDamageExplosions, STATGROUP_GCRadialDamage);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queued explosions"), STAT_GCRadialDamageQueued, STATGROUP_GCRadialDamage);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hash rebuilds"), STAT_GCRadialDamageRebuilds, STATGROUP_GCRadialDamage);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Candidates"), STAT_GCRadialDamageCandidates, STATGROUP_GCRadialDamage);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Occlusion traces"), STAT_GCRadialDamageTraces, STATGROUP_GCRadialDamage);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Merged fx"), STAT_GCRadialDamageMergedFX, STATGROUP_GCRadialDamage);
+
+static float RadialDamageCellSize = 1000.f;
+static FAutoConsoleVariableRef CVarRadialDamageCellSize(
+	TEXT("gc.RadialDamage.CellSize"),
+	RadialDamageCellSize,
+	TEXT("Cell size of the damageable actors spatial hash"));
+
+static float ExplosionFXMergeDistance = 300.f;
+static FAutoConsoleVariableRef CVarExplosionFXMergeDistance(
+	TEXT("gc.RadialDamage.FXMergeDistance"),
+	ExplosionFXMergeDistance,
+	TEXT("Queued explosions of the same fx closer than this play the fx once, in their center. 0 - no merging"));
+
+static float OcclusionMergeDistance = 50.f;
+static FAutoConsoleVariableRef CVarOcclusionMergeDistance(
+	TEXT("gc.RadialDamage.OcclusionMergeDistance"),
+	OcclusionMergeDistance,
+	TEXT("Overlapping explosions closer than this share their occlusion traces to a victim. 0 - every explosion traces its victims"));
+
+void UGCRadialDamageSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_GCRadialDamageActors, Actors.Num());
+	Actors.Empty();
+	Radii.Empty();
+	Cells.Empty();
+	PendingExplosions.Empty();
+	ResolvedExplosions.Empty();
+	Super::Deinitialize();
+}
+
+void UGCRadialDamageSubsystem::Tick(float DeltaTime)
+{
+	GC_TRACE_SCOPE(UGCRadialDamageSubsystem_ResolveExplosions);
+	Swap(PendingExplosions, ResolvedExplosions);
+	PlayMergedFX();
+	ResolveQueuedExplosions();
+	ResolvedExplosions.Reset();
+}
+
+bool UGCRadialDamageSubsystem::IsTickable() const
+{
+	return !IsTemplate() && PendingExplosions.Num() > 0;
+}
+
+TStatId UGCRadialDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCRadialDamageSubsystem, STATGROUP_Tickables);
+}
+
+void UGCRadialDamageSubsystem::RegisterDamageable(AActor* Actor)
+{
+	if (!IsValid(Actor) || Actors.Contains(Actor))
+	{
+		return;
+	}
+
+	Actors.Add(Actor);
+	const float Radius = Actor->GetSimpleCollisionRadius();
+	Radii.Add(Radius);
+	MaxRadius = FMath::Max(MaxRadius, Radius);
+	bHashDirty = true;
+	INC_DWORD_STAT(STAT_GCRadialDamageActors);
+}
+
+void UGCRadialDamageSubsystem::UnregisterDamageable(AActor* Actor)
+{
+	const int32 Index = Actors.IndexOfByKey(Actor);
+	if (Index != INDEX_NONE)
+	{
+		Actors.RemoveAtSwap(Index);
+		Radii.RemoveAtSwap(Index);
+		bHashDirty = true;
+		DEC_DWORD_STAT(STAT_GCRadialDamageActors);
+	}
+}
+
+void UGCRadialDamageSubsystem::QueueExplosion(const FQueuedExplosion& Explosion)
+{
+	INC_DWORD_STAT(STAT_GCRadialDamageQueued);
+	PendingExplosions.Add(Explosion);
+}
+
+void UGCRadialDamageSubsystem::ResolveQueuedExplosions()
+{
+	INC_DWORD_STAT_BY(STAT_GCRadialDamageExplosions, ResolvedExplosions.Num());
+	RebuildHashIfNeeded();
+
+	// 1. overlapping blasts are clustered and share one broad phase
+	struct FExplosionCluster
+	{
+		FBox Bounds = FBox(ForceInit);
+		TArray<int32, TInlineAllocator<8>> Explosions;
+	};
+	
+	TArray<FExplosionCluster, TInlineAllocator<4>> Clusters;
+	for (int32 i = 0; i < ResolvedExplosions.Num(); ++i)
+	{
+		const FQueuedExplosion& Explosion = ResolvedExplosions[i];
+		FExplosionCluster NewCluster;
+		NewCluster.Bounds = FBox::BuildAABB(Explosion.Origin, FVector(Explosion.Params.OuterRadius));
+		NewCluster.Explosions.Add(i);
+
+		// a blast bridging several clusters joins them all. The grown bounds can reach more clusters, so repeat until none
+		bool bMerged = true;
+		while (bMerged)
+		{
+			bMerged = false;
+			for (int32 ClusterIndex = Clusters.Num() - 1; ClusterIndex >= 0; --ClusterIndex)
+			{
+				FExplosionCluster& Cluster = Clusters[ClusterIndex];
+				if (Cluster.Bounds.Intersect(NewCluster.Bounds))
+				{
+					NewCluster.Bounds += Cluster.Bounds;
+					NewCluster.Explosions.Append(Cluster.Explosions);
+					Clusters.RemoveAtSwap(ClusterIndex);
+					bMerged = true;
+				}
+			}
+		}
+
+		Clusters.Add(MoveTemp(NewCluster));
+	}
+
+	// 2. damage of all explosions summed per victim. Occlusion of a cluster is traced in one batch
+	TArray<FRadialDamageTarget, TInlineAllocator<16>> Targets;
+	FOcclusionTraces OcclusionTraces;
+	FPendingDamages PendingDamages;
+	for (const FExplosionCluster& Cluster : Clusters)
+	{
+		FCandidates Candidates;
+		if (!GatherCandidates(Cluster.Bounds, Candidates))
+		{
+			continue;
+		}
+
+		// explosives of the cluster don't block each other's blasts
+		FCollisionQueryParams OcclusionParams(SCENE_QUERY_STAT(GCRadialDamageOcclusion));
+		OcclusionTraces.Reset();
+		PendingDamages.Reset();
+		for (const int32 ExplosionIndex : Cluster.Explosions)
+		{
+			const FQueuedExplosion& Explosion = ResolvedExplosions[ExplosionIndex];
+			OcclusionParams.AddIgnoredActor(Explosion.DamageCauser.Get());
+			ComputeDistancesSq(Candidates, Explosion.Origin);
+			GatherPendingDamage(Candidates, ExplosionIndex, OcclusionTraces, PendingDamages);
+		}
+
+		TraceOcclusion(OcclusionTraces, OcclusionParams);
+		for (const FPendingDamage& PendingDamage : PendingDamages)
+		{
+			const FOcclusionTrace& OcclusionTrace = OcclusionTraces[PendingDamage.TraceIndex];
+			if (OcclusionTrace.bOccluded)
+			{
+				continue;
+			}
+
+			AActor* Actor = OcclusionTrace.Actor;
+			FRadialDamageTarget* Target = Targets.FindByPredicate([Actor](const FRadialDamageTarget& Entry) { return Entry.Actor == Actor; });
+			if (Target == nullptr)
+			{
+				Target = &Targets.AddDefaulted_GetRef();
+				Target->Actor = Actor;
+			}
+
+			Target->Damage += PendingDamage.Damage;
+			if (PendingDamage.Damage > Target->BiggestDamage)
+			{
+				Target->BiggestDamage = PendingDamage.Damage;
+				Target->ExplosionIndex = PendingDamage.ExplosionIndex;
+			}
+		}
+	}
+
+	// 3. one damage event per victim, on behalf of the explosion that hurt it the most
+	for (const FRadialDamageTarget& Target : Targets)
+	{
+		AActor* Actor = Target.Actor.Get();
+		if (IsValid(Actor))
+		{
+			const FQueuedExplosion& Explosion = ResolvedExplosions[Target.ExplosionIndex];
+			ApplyDamageToActor(Actor, Target.Damage, Explosion.Params, Explosion.Origin, Explosion.DamageTypeClass,
+				Explosion.InstigatedByController.Get(), Explosion.DamageCauser.Get());
+		}
+	}
+}
+
+void UGCRadialDamageSubsystem::PlayMergedFX()
+{
+	UGCFXSubsystem* FXSubsystem = GetWorld()->GetSubsystem<UGCFXSubsystem>();
+	const float MergeDistanceSq = FMath::Square(ExplosionFXMergeDistance);
+	TBitArray<> Merged(false, ResolvedExplosions.Num());
+	for (int32 i = 0; i < ResolvedExplosions.Num(); ++i)
+	{
+		if (Merged[i])
+		{
+			continue;
+		}
+
+		// greedy: explosions close to the first one with the same fx join it
+		const FQueuedExplosion& Explosion = ResolvedExplosions[i];
+		FVector LocationSum = Explosion.Origin;
+		int32 Count = 1;
+		for (int32 j = i + 1; j < ResolvedExplosions.Num(); ++j)
+		{
+			const FQueuedExplosion& Other = ResolvedExplosions[j];
+			if (!Merged[j] && Other.NiagaraFX == Explosion.NiagaraFX && Other.CascadeFX == Explosion.CascadeFX && Other.Sound == Explosion.Sound
+				&& FVector::DistSquared(Explosion.Origin, Other.Origin) <= MergeDistanceSq)
+			{
+				Merged[j] = true;
+				LocationSum += Other.Origin;
+				Count++;
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_GCRadialDamageMergedFX, Count - 1);
+		const FVector Location = LocationSum / Count;
+		if (Explosion.NiagaraFX.IsValid())
+		{
+			FXSubsystem->SpawnNiagaraAtLocation(Explosion.NiagaraFX.Get(), Location);
+		}
+		else
+		{
+			FXSubsystem->SpawnCascadeAtLocation(Explosion.CascadeFX.Get(), Location);
+		}
+
+		FXSubsystem->PlaySoundAtLocation(Explosion.Sound.Get(), Location);
+	}
+}
+
+bool UGCRadialDamageSubsystem::GatherCandidates(const FBox& Bounds, FCandidates& OutCandidates) const
+{
+	const FIntVector MinCell = GetCell(Bounds.Min - FVector(MaxRadius));
+	const FIntVector MaxCell = GetCell(Bounds.Max + FVector(MaxRadius));
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<int32, TInlineAllocator<4>>* Cell = Cells.Find(FIntVector(X, Y, Z));
+				if (Cell != nullptr)
+				{
+					OutCandidates.Indices.Append(*Cell);
+				}
+			}
+		}
+	}
+
+	const int32 Count = OutCandidates.Indices.Num();
+	if (Count == 0)
+	{
+		return false;
+	}
+
+	INC_DWORD_STAT_BY(STAT_GCRadialDamageCandidates, Count);
+	// scratch is padded so the last iteration of the distance kernel doesn't read past the end
+	const int32 PaddedCount = Align(Count, 4);
+	OutCandidates.X.SetNumZeroed(PaddedCount);
+	OutCandidates.Y.SetNumZeroed(PaddedCount);
+	OutCandidates.Z.SetNumZeroed(PaddedCount);
+	OutCandidates.DistancesSq.SetNumUninitialized(PaddedCount);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const int32 Index = OutCandidates.Indices[i];
+		OutCandidates.X[i] = LocationsX[Index];
+		OutCandidates.Y[i] = LocationsY[Index];
+		OutCandidates.Z[i] = LocationsZ[Index];
+	}
+
+	return true;
+}
+
+void UGCRadialDamageSubsystem::ComputeDistancesSq(FCandidates& Candidates, const FVector& Origin) const
+{
+	// 4 candidates per iteration
+	const VectorRegister OriginX = VectorSetFloat1(Origin.X);
+	const VectorRegister OriginY = VectorSetFloat1(Origin.Y);
+	const VectorRegister OriginZ = VectorSetFloat1(Origin.Z);
+	for (int32 i = 0; i < Candidates.DistancesSq.Num(); i += 4)
+	{
+		const VectorRegister DeltaX = VectorSubtract(VectorLoad(&Candidates.X[i]), OriginX);
+		const VectorRegister DeltaY = VectorSubtract(VectorLoad(&Candidates.Y[i]), OriginY);
+		const VectorRegister DeltaZ = VectorSubtract(VectorLoad(&Candidates.Z[i]), OriginZ);
+		const VectorRegister DistanceSq = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+		VectorStore(DistanceSq, &Candidates.DistancesSq[i]);
+	}
+}
+
+void UGCRadialDamageSubsystem::GatherPendingDamage(const FCandidates& Candidates, int32 ExplosionIndex, FOcclusionTraces& InOutTraces,
+	FPendingDamages& OutDamages) const
+{
+	const FQueuedExplosion& Explosion = ResolvedExplosions[ExplosionIndex];
+	const FRadialDamageParams& Params = Explosion.Params;
+	const AActor* DamageCauser = Explosion.DamageCauser.Get();
+	const float MergeDistanceSq = FMath::Square(OcclusionMergeDistance);
+	for (int32 i = 0; i < Candidates.Indices.Num(); ++i)
+	{
+		const int32 Index = Candidates.Indices[i];
+		AActor* Actor = Actors[Index].Get();
+		const float Distance = FMath::Max(FMath::Sqrt(Candidates.DistancesSq[i]) - Radii[Index], 0.f);
+		if (Distance > Params.OuterRadius || !IsValid(Actor) || Actor == DamageCauser)
+		{
+			continue;
+		}
+
+		// a blast next to one already tracing this victim sees it the same way
+		int32 TraceIndex = InOutTraces.IndexOfByPredicate([&](const FOcclusionTrace& Trace)
+		{
+			return Trace.Actor == Actor && Trace.Channel == Explosion.OcclusionChannel
+				&& FVector::DistSquared(Trace.Origin, Explosion.Origin) <= MergeDistanceSq;
+		});
+		
+		if (TraceIndex == INDEX_NONE)
+		{
+			TraceIndex = InOutTraces.Num();
+			FOcclusionTrace& Trace = InOutTraces.AddDefaulted_GetRef();
+			Trace.Origin = Explosion.Origin;
+			Trace.Target = FVector(Candidates.X[i], Candidates.Y[i], Candidates.Z[i]);
+			Trace.Actor = Actor;
+			Trace.Channel = Explosion.OcclusionChannel;
+		}
+
+		FPendingDamage& PendingDamage = OutDamages.AddDefaulted_GetRef();
+		PendingDamage.TraceIndex = TraceIndex;
+		PendingDamage.ExplosionIndex = ExplosionIndex;
+		PendingDamage.Damage = FMath::Lerp(Params.MinimumDamage, Params.BaseDamage, Params.GetDamageScale(Distance));
+	}
+}
+
+void UGCRadialDamageSubsystem::TraceOcclusion(FOcclusionTraces& Traces, const FCollisionQueryParams& OcclusionParams) const
+{
+	// scene queries are safe off the game thread, the batch is split between task threads
+	const UWorld* World = GetWorld();
+	INC_DWORD_STAT_BY(STAT_GCRadialDamageTraces, Traces.Num());
+	GC_COUNT_TRACES(Traces.Num());
+	ParallelFor(Traces.Num(), [&](int32 i)
+	{
+		FOcclusionTrace& Trace = Traces[i];
+		FHitResult OcclusionHit;
+		Trace.bOccluded = World->LineTraceSingleByChannel(OcclusionHit, Trace.Origin, Trace.Target, Trace.Channel, OcclusionParams)
+			&& OcclusionHit.GetActor() != Trace.Actor;
+	});
+}
+
+void UGCRadialDamageSubsystem::ApplyDamageToActor(AActor* Actor, float Damage, const FRadialDamageParams& Params, const FVector& Origin,
+	TSubclassOf<UDamageType> DamageTypeClass, AController* InstigatedByController, AActor* DamageCauser) const
+{
+	// damage is already scaled, so the event carries min = base = damage and the actor's own falloff is a no-op
+	FRadialDamageEvent DamageEvent;
+	DamageEvent.DamageTypeClass = DamageTypeClass ? DamageTypeClass : TSubclassOf<UDamageType>(UDamageType::StaticClass());
+	DamageEvent.Origin = Origin;
+	DamageEvent.Params = Params;
+	DamageEvent.Params.BaseDamage = Damage;
+	DamageEvent.Params.MinimumDamage = Damage;
+	FHitResult& Hit = DamageEvent.ComponentHits.AddDefaulted_GetRef();
+	Hit.Actor = Actor;
+	Hit.Component = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+	Hit.Location = Hit.ImpactPoint = Actor->GetActorLocation();
+	Hit.Normal = Hit.ImpactNormal = (Origin - Hit.ImpactPoint).GetSafeNormal();
+	Actor->TakeDamage(Damage, DamageEvent, InstigatedByController, DamageCauser);
+}
+
+void UGCRadialDamageSubsystem::RebuildHashIfNeeded()
+{
+	if (!bHashDirty && HashFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	GC_TRACE_SCOPE(UGCRadialDamageSubsystem_RebuildHash);
+	INC_DWORD_STAT(STAT_GCRadialDamageRebuilds);
+	HashFrame = GFrameCounter;
+	bHashDirty = false;
+	for (int32 i = Actors.Num() - 1; i >= 0; --i)
+	{
+		if (!Actors[i].IsValid())
+		{
+			Actors.RemoveAtSwap(i);
+			Radii.RemoveAtSwap(i);
+			DEC_DWORD_STAT(STAT_GCRadialDamageActors);
+		}
+	}
+
+	const int32 Count = Actors.Num();
+	LocationsX.SetNumUninitialized(Count, false);
+	LocationsY.SetNumUninitialized(Count, false);
+	LocationsZ.SetNumUninitialized(Count, false);
+	Cells.Reset();
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const FVector Location = Actors[i]->GetActorLocation();
+		LocationsX[i] = Location.X;
+		LocationsY[i] = Location.Y;
+		LocationsZ[i] = Location.Z;
+		Cells.FindOrAdd(GetCell(Location)).Add(i);
+	}
+}
+
+FIntVector UGCRadialDamageSubsystem::GetCell(const FVector& Location) const
+{
+	const float CellSize = FMath::Max(RadialDamageCellSize, 100.f);
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
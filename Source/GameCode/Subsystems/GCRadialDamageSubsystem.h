@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCRadialDamageSubsystem.generated.h"
+
+class UDamageType;
+class UNiagaraSystem;
+class UParticleSystem;
+class USoundBase;
+
+// Explosion resolved together with the rest of explosions of the frame, see UGCRadialDamageSubsystem::QueueExplosion
+struct FQueuedExplosion
+{
+	FRadialDamageParams Params;
+	FVector Origin = FVector::ZeroVector;
+	TSubclassOf<UDamageType> DamageTypeClass;
+	TWeakObjectPtr<AActor> DamageCauser;
+	TWeakObjectPtr<AController> InstigatedByController;
+	ECollisionChannel OcclusionChannel = ECC_Visibility;
+
+	// fx of close explosions of the same systems are played once
+	TWeakObjectPtr<UNiagaraSystem> NiagaraFX;
+	TWeakObjectPtr<UParticleSystem> CascadeFX;
+	TWeakObjectPtr<USoundBase> Sound;
+};
+
+/**
+ * Radial damage against registered damageable actors (characters, turrets) instead of a physics overlap over every component.
+ * Actors are put into a spatial hash that is rebuilt at most once per frame, so chained explosions in one frame share it.
+ * Candidate distances are computed four at a time. Queued explosions of a frame are resolved at once: overlapping blasts share
+ * one broad phase and one batch of occlusion traces, where blasts close to each other trace a victim once. Each victim gets
+ * one damage event and fx of blasts close to each other are merged
+ */
+UCLASS()
+class GAMECODE_API UGCRadialDamageSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterDamageable(AActor* Actor);
+	void UnregisterDamageable(AActor* Actor);
+
+	// Same falloff as UGameplayStatics::ApplyRadialDamageWithFalloff. Damage and fx are applied at the end of the frame.
+	// The damage causer is not damaged by its own explosion
+	void QueueExplosion(const FQueuedExplosion& Explosion);
+
+private:
+	// damage of one or more explosions to one actor
+	struct FRadialDamageTarget
+	{
+		TWeakObjectPtr<AActor> Actor;
+		float Damage = 0.f;
+		// explosion that did the most damage, its origin, causer and instigator go to the damage event
+		int32 ExplosionIndex = INDEX_NONE;
+		float BiggestDamage = 0.f;
+	};
+
+	// candidates from the hash with their locations per axis, padded to 4 for the distance kernel
+	struct FCandidates
+	{
+		TArray<int32, TInlineAllocator<32>> Indices;
+		TArray<float, TInlineAllocator<32>> X;
+		TArray<float, TInlineAllocator<32>> Y;
+		TArray<float, TInlineAllocator<32>> Z;
+		TArray<float, TInlineAllocator<32>> DistancesSq;
+	};
+
+	void RebuildHashIfNeeded();
+	FIntVector GetCell(const FVector& Location) const;
+	bool GatherCandidates(const FBox& Bounds, FCandidates& OutCandidates) const;
+	void ComputeDistancesSq(FCandidates& Candidates, const FVector& Origin) const;
+
+	// origin to victim line of sight, shared by blasts of a cluster close to each other
+	struct FOcclusionTrace
+	{
+		FVector Origin = FVector::ZeroVector;
+		FVector Target = FVector::ZeroVector;
+		AActor* Actor = nullptr;
+		ECollisionChannel Channel = ECC_Visibility;
+		bool bOccluded = false;
+	};
+
+	// falloff damage of one explosion to one actor, applied if its occlusion trace is clear
+	struct FPendingDamage
+	{
+		int32 TraceIndex = INDEX_NONE;
+		int32 ExplosionIndex = INDEX_NONE;
+		float Damage = 0.f;
+	};
+
+	using FOcclusionTraces = TArray<FOcclusionTrace, TInlineAllocator<32>>;
+	using FPendingDamages = TArray<FPendingDamage, TInlineAllocator<32>>;
+
+	// Falloff damage of the explosion to the candidates, with the occlusion traces it needs
+	void GatherPendingDamage(const FCandidates& Candidates, int32 ExplosionIndex, FOcclusionTraces& InOutTraces,
+		FPendingDamages& OutDamages) const;
+	void TraceOcclusion(FOcclusionTraces& Traces, const FCollisionQueryParams& OcclusionParams) const;
+	void ApplyDamageToActor(AActor* Actor, float Damage, const FRadialDamageParams& Params, const FVector& Origin,
+		TSubclassOf<UDamageType> DamageTypeClass, AController* InstigatedByController, AActor* DamageCauser) const;
+	void ResolveQueuedExplosions();
+	void PlayMergedFX();
+
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	TArray<float> Radii;
+	float MaxRadius = 0.f;
+
+	// actor locations at the last rebuild, per axis for the distance kernel
+	TArray<float> LocationsX;
+	TArray<float> LocationsY;
+	TArray<float> LocationsZ;
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Cells;
+	uint64 HashFrame = 0;
+	bool bHashDirty = true;
+
+	TArray<FQueuedExplosion> PendingExplosions;
+	// swapped with PendingExplosions on resolve, so explosions caused by explosions go to the next frame
+	TArray<FQueuedExplosion> ResolvedExplosions;
+};
@@ -0,0 +1,189 @@
+#include "GCTrajectoryPredictionSubsystem.h"
+
+#include "GameCode.h"
+
+DECLARE_STATS_GROUP(TEXT("GameCode Trajectory Prediction"), STATGROUP_GCTrajectory, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Predictions"), STAT_GCTrajectoryPredictions, STATGROUP_GCTrajectory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Arcs solved"), STAT_GCTrajectoryArcsSolved, STATGROUP_GCTrajectory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Segment sweeps"), STAT_GCTrajectorySweeps, STATGROUP_GCTrajectory);
+
+static int32 TrajectorySegments = 16;
+static FAutoConsoleVariableRef CVarTrajectorySegments(
+	TEXT("gc.Trajectory.Segments"),
+	TrajectorySegments,
+	TEXT("Amount of segments of a predicted arc"));
+
+static float TrajectoryMaxTime = 3.f;
+static FAutoConsoleVariableRef CVarTrajectoryMaxTime(
+	TEXT("gc.Trajectory.MaxTime"),
+	TrajectoryMaxTime,
+	TEXT("Flight time covered by a predicted arc, seconds"));
+
+static float TrajectoryLaunchTolerance = 2.f;
+static FAutoConsoleVariableRef CVarTrajectoryLaunchTolerance(
+	TEXT("gc.Trajectory.LaunchTolerance"),
+	TrajectoryLaunchTolerance,
+	TEXT("Launch location (cm) and velocity (cm/s) changes below this reuse the cached arc"));
+
+static int32 TrajectoryRefreshSegments = 1;
+static FAutoConsoleVariableRef CVarTrajectoryRefreshSegments(
+	TEXT("gc.Trajectory.RefreshSegments"),
+	TrajectoryRefreshSegments,
+	TEXT("Segments of an unchanged arc swept again per prediction, round robin, to catch moving obstacles"));
+
+void UGCTrajectoryPredictionSubsystem::Deinitialize()
+{
+	Arcs.Empty();
+	Super::Deinitialize();
+}
+
+const FPredictedArc& UGCTrajectoryPredictionSubsystem::PredictArc(const AActor* Thrower, const FVector& Start, const FVector& Velocity,
+	float GravityZ, float Radius, ECollisionChannel TraceChannel)
+{
+	GC_TRACE_SCOPE(UGCTrajectoryPredictionSubsystem_PredictArc);
+	INC_DWORD_STAT(STAT_GCTrajectoryPredictions);
+	FCachedArc* CachedArc = Arcs.Find(Thrower);
+	if (CachedArc == nullptr)
+	{
+		// good time to drop arcs of destroyed throwers
+		for (auto It = Arcs.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		
+		CachedArc = &Arcs.Add(Thrower);
+	}
+
+	const int32 SegmentsCount = FMath::Max(TrajectorySegments, 1);
+	if (CachedArc->Arc.Points.Num() != SegmentsCount + 1
+		|| !CachedArc->Start.Equals(Start, TrajectoryLaunchTolerance)
+		|| !CachedArc->Velocity.Equals(Velocity, TrajectoryLaunchTolerance)
+		|| CachedArc->GravityZ != GravityZ || CachedArc->Radius != Radius)
+	{
+		CachedArc->Start = Start;
+		CachedArc->Velocity = Velocity;
+		CachedArc->GravityZ = GravityZ;
+		CachedArc->Radius = Radius;
+		SolveArc(*CachedArc);
+	}
+	else
+	{
+		for (int32 i = 0; i < TrajectoryRefreshSegments; ++i)
+		{
+			CachedArc->NextRefreshSegment = (CachedArc->NextRefreshSegment + 1) % SegmentsCount;
+			CachedArc->DirtySegments[CachedArc->NextRefreshSegment] = true;
+		}
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GCTrajectoryPrediction));
+	for (const AActor* Current = Thrower; IsValid(Current); Current = Current->GetOwner())
+	{
+		QueryParams.AddIgnoredActor(Current);
+	}
+
+	FPredictedArc& Arc = CachedArc->Arc;
+	Arc.HitSegment = INDEX_NONE;
+	for (int32 Segment = 0; Segment < SegmentsCount; ++Segment)
+	{
+		if (CachedArc->DirtySegments[Segment])
+		{
+			SweepSegment(*CachedArc, Segment, TraceChannel, QueryParams);
+		}
+
+		// segments after the first blocked one stay dirty, nothing reaches them
+		if (CachedArc->BlockedSegments[Segment])
+		{
+			Arc.HitSegment = Segment;
+			Arc.Hit = CachedArc->SegmentHits[Segment];
+			break;
+		}
+	}
+
+	return Arc;
+}
+
+void UGCTrajectoryPredictionSubsystem::NotifyGeometryChanged(const FBox& Box)
+{
+	for (auto& Entry : Arcs)
+	{
+		FCachedArc& CachedArc = Entry.Value;
+		const TArray<FVector>& Points = CachedArc.Arc.Points;
+		const FBox ExpandedBox = Box.ExpandBy(CachedArc.Radius);
+		for (int32 Segment = 0; Segment + 1 < Points.Num(); ++Segment)
+		{
+			const FVector& SegmentStart = Points[Segment];
+			const FVector SegmentDelta = Points[Segment + 1] - SegmentStart;
+			if (FMath::LineBoxIntersection(ExpandedBox, SegmentStart, Points[Segment + 1], SegmentDelta))
+			{
+				CachedArc.DirtySegments[Segment] = true;
+			}
+		}
+	}
+}
+
+bool UGCTrajectoryPredictionSubsystem::SolveLaunchVelocity(const FVector& Start, const FVector& Target, float Speed, float GravityZ,
+	bool bHighArc, FVector& OutVelocity)
+{
+	const FVector Delta = Target - Start;
+	const FVector HorizontalDelta(Delta.X, Delta.Y, 0.f);
+	const float Distance = HorizontalDelta.Size();
+	const float Gravity = -GravityZ;
+	const float SpeedSq = Speed * Speed;
+	if (Distance < KINDA_SMALL_NUMBER || Gravity < KINDA_SMALL_NUMBER)
+	{
+		OutVelocity = Delta.GetSafeNormal() * Speed;
+		return !Delta.IsNearlyZero();
+	}
+
+	// tan(angle) = (v^2 +- sqrt(v^4 - g * (g * d^2 + 2 * h * v^2))) / (g * d)
+	const float Discriminant = SpeedSq * SpeedSq - Gravity * (Gravity * Distance * Distance + 2.f * Delta.Z * SpeedSq);
+	if (Discriminant < 0.f)
+	{
+		return false;
+	}
+
+	const float Root = FMath::Sqrt(Discriminant);
+	const float Angle = FMath::Atan((SpeedSq + (bHighArc ? Root : -Root)) / (Gravity * Distance));
+	float Sin, Cos;
+	FMath::SinCos(&Sin, &Cos, Angle);
+	OutVelocity = HorizontalDelta / Distance * Cos * Speed + FVector::UpVector * Sin * Speed;
+	return true;
+}
+
+void UGCTrajectoryPredictionSubsystem::SolveArc(FCachedArc& CachedArc) const
+{
+	INC_DWORD_STAT(STAT_GCTrajectoryArcsSolved);
+	const int32 SegmentsCount = FMath::Max(TrajectorySegments, 1);
+	FPredictedArc& Arc = CachedArc.Arc;
+	Arc.TimeStep = TrajectoryMaxTime / SegmentsCount;
+	Arc.Points.SetNumUninitialized(SegmentsCount + 1, false);
+	const FVector Acceleration(0.f, 0.f, CachedArc.GravityZ);
+	for (int32 i = 0; i <= SegmentsCount; ++i)
+	{
+		const float Time = i * Arc.TimeStep;
+		Arc.Points[i] = CachedArc.Start + CachedArc.Velocity * Time + 0.5f * Acceleration * Time * Time;
+	}
+
+	CachedArc.DirtySegments.Init(true, SegmentsCount);
+	CachedArc.BlockedSegments.Init(false, SegmentsCount);
+	CachedArc.SegmentHits.SetNum(SegmentsCount, false);
+	CachedArc.NextRefreshSegment = 0;
+}
+
+void UGCTrajectoryPredictionSubsystem::SweepSegment(FCachedArc& CachedArc, int32 Segment, ECollisionChannel TraceChannel,
+	const FCollisionQueryParams& QueryParams) const
+{
+	INC_DWORD_STAT(STAT_GCTrajectorySweeps);
+	GC_COUNT_TRACES(1);
+	const FVector& Start = CachedArc.Arc.Points[Segment];
+	const FVector& End = CachedArc.Arc.Points[Segment + 1];
+	FHitResult& Hit = CachedArc.SegmentHits[Segment];
+	const bool bHit = CachedArc.Radius > 0.f
+		? GetWorld()->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, TraceChannel, FCollisionShape::MakeSphere(CachedArc.Radius), QueryParams)
+		: GetWorld()->LineTraceSingleByChannel(Hit, Start, End, TraceChannel, QueryParams);
+	CachedArc.BlockedSegments[Segment] = bHit;
+	CachedArc.DirtySegments[Segment] = false;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCTrajectoryPredictionSubsystem.generated.h"
+
+struct FPredictedArc
+{
+	// Points[0] is the launch location, samples are TimeStep apart
+	TArray<FVector> Points;
+	float TimeStep = 0.f;
+	// index of the segment ending at Points[HitSegment + 1] that hits something
+	int32 HitSegment = INDEX_NONE;
+	FHitResult Hit;
+
+	bool IsBlocked() const { return HitSegment != INDEX_NONE; }
+};
+
+/**
+ * Ballistic arcs of throwables without simulating them. Points are solved analytically, arc segments are swept once
+ * and cached per thrower. While the launch stays the same only segments near reported geometry changes and a few
+ * round robin segments are swept again, so a trajectory preview or AI target check costs a couple of sweeps per frame
+ */
+UCLASS()
+class GAMECODE_API UGCTrajectoryPredictionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	const FPredictedArc& PredictArc(const AActor* Thrower, const FVector& Start, const FVector& Velocity, float GravityZ, float Radius,
+		ECollisionChannel TraceChannel = ECC_Visibility);
+	void ForgetThrower(const AActor* Thrower) { Arcs.Remove(Thrower); }
+
+	// Segments of cached arcs crossing the box are swept again on the next prediction
+	void NotifyGeometryChanged(const FBox& Box);
+
+	// Launch velocity of Speed hitting Target. False if Target is out of reach
+	static bool SolveLaunchVelocity(const FVector& Start, const FVector& Target, float Speed, float GravityZ, bool bHighArc,
+		FVector& OutVelocity);
+
+private:
+	struct FCachedArc
+	{
+		FPredictedArc Arc;
+		FVector Start = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+		float GravityZ = 0.f;
+		float Radius = 0.f;
+		TBitArray<> DirtySegments;
+		TBitArray<> BlockedSegments;
+		TArray<FHitResult> SegmentHits;
+		int32 NextRefreshSegment = 0;
+	};
+
+	void SolveArc(FCachedArc& CachedArc) const;
+	void SweepSegment(FCachedArc& CachedArc, int32 Segment, ECollisionChannel TraceChannel, const FCollisionQueryParams& QueryParams) const;
+
+	TMap<TWeakObjectPtr<const AActor>, FCachedArc> Arcs;
+};
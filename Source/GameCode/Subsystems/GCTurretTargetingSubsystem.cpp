@@ -0,0 +1,98 @@
+#include "GCTurretTargetingSubsystem.h"
+
+#include "GameCode.h"
+#include "AI/Characters/Turret.h"
+#include "Components/Combat/TurretBarrelComponent.h"
+
+DECLARE_STATS_GROUP(TEXT("GameCode Turret Targeting"), STATGROUP_GCTurretTargeting, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lead solves"), STAT_GCTurretTargetingSolves, STATGROUP_GCTurretTargeting);
+DECLARE_DWORD_COUNTER_STAT(TEXT("No intercept"), STAT_GCTurretTargetingMisses, STATGROUP_GCTurretTargeting);
+
+void UGCTurretTargetingSubsystem::Deinitialize()
+{
+	PendingTurrets.Empty();
+	Super::Deinitialize();
+}
+
+void UGCTurretTargetingSubsystem::Tick(float DeltaTime)
+{
+	GC_TRACE_SCOPE(UGCTurretTargetingSubsystem_SolveLeads);
+	const float GravityZ = GetWorld()->GetGravityZ();
+	for (const TWeakObjectPtr<ATurret>& TurretPtr : PendingTurrets)
+	{
+		ATurret* Turret = TurretPtr.Get();
+		if (!IsValid(Turret))
+		{
+			continue;
+		}
+
+		const AActor* Target = Turret->GetCurrentTarget();
+		float ProjectileSpeed = 0.f;
+		float GravityScale = 0.f;
+		if (!IsValid(Target) || !Turret->GetBarrel()->GetProjectileBallistics(ProjectileSpeed, GravityScale))
+		{
+			Turret->SetAimLead(FVector::ZeroVector);
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_GCTurretTargetingSolves);
+		const FVector TargetVelocity = Target->GetVelocity();
+		float InterceptTime = 0.f;
+		if (!SolveInterceptTime(Turret->GetBarrel()->GetComponentLocation(), Target->GetActorLocation(), TargetVelocity, ProjectileSpeed,
+			InterceptTime))
+		{
+			INC_DWORD_STAT(STAT_GCTurretTargetingMisses);
+			Turret->SetAimLead(FVector::ZeroVector);
+			continue;
+		}
+
+		// aim above the intercept point by the drop over the flight time
+		const float Drop = 0.5f * GravityZ * GravityScale * InterceptTime * InterceptTime;
+		Turret->SetAimLead(TargetVelocity * InterceptTime - FVector(0.f, 0.f, Drop));
+	}
+
+	PendingTurrets.Reset();
+}
+
+bool UGCTurretTargetingSubsystem::IsTickable() const
+{
+	return !IsTemplate() && PendingTurrets.Num() > 0;
+}
+
+TStatId UGCTurretTargetingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCTurretTargetingSubsystem, STATGROUP_Tickables);
+}
+
+void UGCTurretTargetingSubsystem::RequestLead(ATurret* Turret)
+{
+	PendingTurrets.AddUnique(Turret);
+}
+
+bool UGCTurretTargetingSubsystem::SolveInterceptTime(const FVector& Origin, const FVector& TargetLocation, const FVector& TargetVelocity,
+	float Speed, float& OutTime)
+{
+	// |Delta + TargetVelocity * t| = Speed * t
+	const FVector Delta = TargetLocation - Origin;
+	const float A = TargetVelocity.SizeSquared() - Speed * Speed;
+	const float B = 2.f * FVector::DotProduct(Delta, TargetVelocity);
+	const float C = Delta.SizeSquared();
+	if (FMath::Abs(A) < KINDA_SMALL_NUMBER)
+	{
+		// target is as fast as the projectile
+		OutTime = B < 0.f ? -C / B : -1.f;
+		return OutTime > 0.f;
+	}
+
+	const float Discriminant = B * B - 4.f * A * C;
+	if (Discriminant < 0.f)
+	{
+		return false;
+	}
+
+	const float Root = FMath::Sqrt(Discriminant);
+	const float Time1 = (-B - Root) / (2.f * A);
+	const float Time2 = (-B + Root) / (2.f * A);
+	OutTime = Time1 > 0.f && Time2 > 0.f ? FMath::Min(Time1, Time2) : FMath::Max(Time1, Time2);
+	return OutTime > 0.f;
+}
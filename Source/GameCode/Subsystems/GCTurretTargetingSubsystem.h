@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCTurretTargetingSubsystem.generated.h"
+
+class ATurret;
+
+/**
+ * Lead for turrets shooting projectiles at moving targets. Turret controllers request a solve on their think, all requests
+ * of the frame are solved in one batch and turrets aim at their target plus the lead until the next think
+ */
+UCLASS()
+class GAMECODE_API UGCTurretTargetingSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RequestLead(ATurret* Turret);
+
+	// Time for a projectile of Speed launched from Origin to meet a target at TargetLocation moving with TargetVelocity.
+	// False if the projectile can't catch the target
+	static bool SolveInterceptTime(const FVector& Origin, const FVector& TargetLocation, const FVector& TargetVelocity, float Speed,
+		float& OutTime);
+
+private:
+	TArray<TWeakObjectPtr<ATurret>> PendingTurrets;
+};
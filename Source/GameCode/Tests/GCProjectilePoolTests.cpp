@@ -0,0 +1,79 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Actors/Projectiles/GCProjectile.h"
+#include "Subsystems/GCProjectilePoolSubsystem.h"
+#include "Tests/GCTestWorld.h"
+
+namespace
+{
+	struct FPoolRunResult
+	{
+		int32 Spawns = 0;
+		double ShotsMs = 0.0;
+		double GarbageCollectionMs = 0.0;
+	};
+
+	// ShotsCount projectiles acquired and released one after another, then a full purge
+	FPoolRunResult RunShots(UWorld* World, int32 ShotsCount)
+	{
+		UGCProjectilePoolSubsystem* ProjectilePool = World->GetSubsystem<UGCProjectilePoolSubsystem>();
+		TSet<const AGCProjectile*> Projectiles;
+		FPoolRunResult Result;
+		const double ShotsStart = FPlatformTime::Seconds();
+		for (int32 i = 0; i < ShotsCount; ++i)
+		{
+			AGCProjectile* Projectile = ProjectilePool->AcquireProjectile(AGCProjectile::StaticClass(), FTransform::Identity, nullptr);
+			Projectile->LaunchProjectile(FVector::ForwardVector, 5000.f, nullptr);
+			Projectiles.Add(Projectile);
+			Projectile->Release();
+		}
+
+		Result.ShotsMs = (FPlatformTime::Seconds() - ShotsStart) * 1000.0;
+		Result.Spawns = Projectiles.Num();
+		const double GarbageCollectionStart = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		Result.GarbageCollectionMs = (FPlatformTime::Seconds() - GarbageCollectionStart) * 1000.0;
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCProjectilePoolTest, "GameCode.Projectiles.Pool",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Compares gc.ProjectilePool.Enabled 0 and 1 on the same shots and reports the timings
+bool FGCProjectilePoolTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* PoolEnabled = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.ProjectilePool.Enabled"));
+	if (!TestNotNull(TEXT("gc.ProjectilePool.Enabled"), PoolEnabled))
+	{
+		return false;
+	}
+
+	const int32 PreviousPoolEnabled = PoolEnabled->GetInt();
+	constexpr int32 ShotsCount = 500;
+	FPoolRunResult Spawned;
+	FPoolRunResult Pooled;
+	{
+		FGCTestWorld TestWorld;
+		PoolEnabled->Set(0, ECVF_SetByCode);
+		Spawned = RunShots(TestWorld.World, ShotsCount);
+		PoolEnabled->Set(1, ECVF_SetByCode);
+		Pooled = RunShots(TestWorld.World, ShotsCount);
+	}
+
+	PoolEnabled->Set(PreviousPoolEnabled, ECVF_SetByCode);
+	AddInfo(FString::Printf(TEXT("%d shots spawned: %d actors, %.3f ms per shot, GC %.2f ms"), ShotsCount, Spawned.Spawns,
+		Spawned.ShotsMs / ShotsCount, Spawned.GarbageCollectionMs));
+	AddInfo(FString::Printf(TEXT("%d shots pooled: %d actors, %.3f ms per shot, GC %.2f ms"), ShotsCount, Pooled.Spawns,
+		Pooled.ShotsMs / ShotsCount, Pooled.GarbageCollectionMs));
+
+	TestEqual(TEXT("Every shot spawns without the pool"), Spawned.Spawns, ShotsCount);
+	TestEqual(TEXT("Released projectile is reused"), Pooled.Spawns, 1);
+	return true;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Actors/Projectiles/GCProjectile.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Tests/GCTestWorld.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCProjectileThinWallTest, "GameCode.Projectiles.ThinWallTunneling",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Fast small projectile against a 2 cm wall must stop at the wall whatever the frame rate
+bool FGCProjectileThinWallTest::RunTest(const FString& Parameters)
+{
+	FGCTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+	constexpr float WallX = 1500.f;
+	constexpr float Speed = 20000.f;
+	constexpr float Radius = 5.f;
+	TestWorld.SpawnBox(FVector(WallX, 0.f, 0.f), FVector(1.f, 500.f, 500.f));
+
+	const float FrameRates[] = { 10.f, 15.f, 30.f, 60.f, 144.f };
+	for (const float FrameRate : FrameRates)
+	{
+		AGCProjectile* Projectile = World->SpawnActor<AGCProjectile>(AGCProjectile::StaticClass(), FTransform::Identity);
+		Projectile->FindComponentByClass<USphereComponent>()->SetSphereRadius(Radius);
+		Projectile->LaunchProjectile(FVector::ForwardVector, Speed, nullptr);
+
+		// 15 fps - default MinSubsteppedFrameRate
+		const UProjectileMovementComponent* ProjectileMovement = Projectile->FindComponentByClass<UProjectileMovementComponent>();
+		TestTrue(TEXT("Substeps cover a 15 fps frame"),
+			ProjectileMovement->MaxSimulationTimeStep * ProjectileMovement->MaxSimulationIterations >= 1.f / 15.f - KINDA_SMALL_NUMBER);
+
+		// long enough to fly through the wall twice
+		const float DeltaTime = 1.f / FrameRate;
+		const int32 FramesCount = FMath::CeilToInt(2.f * WallX / Speed / DeltaTime) + 1;
+		for (int32 Frame = 0; Frame < FramesCount; ++Frame)
+		{
+			TestWorld.Tick(DeltaTime);
+		}
+
+		TestTrue(FString::Printf(TEXT("Projectile stopped at the wall at %.0f fps"), FrameRate),
+			Projectile->GetActorLocation().X < WallX);
+		Projectile->Destroy();
+	}
+
+	return true;
+}
+
+#endif
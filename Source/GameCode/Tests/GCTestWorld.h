@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+
+// Game world with its subsystems for automation tests, playing from construction until the helper goes out of scope
+struct FGCTestWorld
+{
+	FGCTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		World->InitializeActorsForPlay(FURL());
+		// no game mode, begin play is dispatched directly
+		World->GetWorldSettings()->NotifyBeginPlay();
+	}
+
+	~FGCTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	void Tick(float DeltaTime) const { World->Tick(LEVELTICK_All, DeltaTime); }
+
+	// Static box blocking everything
+	AActor* SpawnBox(const FVector& Location, const FVector& Extent) const
+	{
+		AActor* Box = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location));
+		UBoxComponent* BoxComponent = NewObject<UBoxComponent>(Box);
+		BoxComponent->SetBoxExtent(Extent);
+		BoxComponent->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Box->SetRootComponent(BoxComponent);
+		BoxComponent->RegisterComponent();
+		BoxComponent->SetWorldLocation(Location);
+		return Box;
+	}
+
+	UWorld* World = nullptr;
+};
+
+#endif
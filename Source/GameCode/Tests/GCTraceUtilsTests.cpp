@@ -0,0 +1,128 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Tests/GCTestWorld.h"
+#include "Utils/GCTraceUtils.h"
+
+namespace
+{
+	// Forwards to the engine allocator and counts game thread allocations while installed
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+		void Install()
+		{
+			check(IsInGameThread() && GMalloc != this);
+			Allocations = 0;
+			InnerMalloc = GMalloc;
+			GMalloc = this;
+		}
+
+		int32 Uninstall()
+		{
+			GMalloc = InnerMalloc;
+			// other threads could still be inside this allocator, so it stays alive and keeps forwarding
+			return Allocations;
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+		virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("GCCountingMalloc"); }
+
+	private:
+		void CountAllocation()
+		{
+			if (IsInGameThread())
+			{
+				Allocations++;
+			}
+		}
+
+		FMalloc* InnerMalloc = nullptr;
+		int32 Allocations = 0;
+	};
+
+	FCountingMalloc CountingMalloc;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTraceUtilsZeroAllocationsTest, "GameCode.Traces.ZeroAllocations",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Hot path queries with cached owner chain params: after the first frame nothing is allocated per query
+bool FGCTraceUtilsZeroAllocationsTest::RunTest(const FString& Parameters)
+{
+	FGCTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+	TestWorld.SpawnBox(FVector(500.f, 0.f, 0.f), FVector(10.f, 200.f, 200.f));
+	AActor* Owner = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	Actor->SetOwner(Owner);
+
+	GCTraceUtils::FOwnerChainQueryParams QueryParams(FName("ZeroAllocationsTest"));
+	const GCTraceUtils::FTraceParams TraceParams;
+	TArray<FHitResult> Hits;
+	Hits.Reserve(16);
+
+	// one frame of what IK, wallrun, ledge detection and melee do
+	auto RunFrame = [&]()
+	{
+		int32 HitsCount = 0;
+		FHitResult Hit;
+		const FCollisionQueryParams& Params = QueryParams.Get(Actor);
+		HitsCount += GCTraceUtils::LineTraceSingleByChannel(World, Hit, FVector::ZeroVector, FVector(1000.f, 0.f, 0.f),
+			ECC_Visibility, Params, TraceParams);
+		HitsCount += GCTraceUtils::SweepSphereSingleByChannel(World, Hit, FVector(0.f, 50.f, 0.f), FVector(1000.f, 50.f, 0.f), 20.f,
+			ECC_Visibility, Params, TraceParams);
+		HitsCount += GCTraceUtils::SweepBoxSingleByChannel(World, Hit, FVector(0.f, -50.f, 0.f), FVector(1000.f, -50.f, 0.f),
+			FVector(10.f), ECC_Visibility, Params, TraceParams);
+		HitsCount += GCTraceUtils::SweepSphereMultiByChannel(World, Hits, FVector(0.f, 0.f, 50.f), FVector(1000.f, 0.f, 50.f), 20.f,
+			ECC_Visibility, Params, TraceParams);
+		return HitsCount;
+	};
+
+	// the first frame builds the params
+	const int32 FirstFrameHits = RunFrame();
+	constexpr int32 FramesCount = 100;
+	int32 HitsCount = 0;
+	CountingMalloc.Install();
+	for (int32 Frame = 0; Frame < FramesCount; ++Frame)
+	{
+		HitsCount += RunFrame();
+	}
+
+	const int32 Allocations = CountingMalloc.Uninstall();
+	TestEqual(TEXT("Every query hits the box"), FirstFrameHits, 4);
+	TestEqual(TEXT("Hits after the first frame"), HitsCount, FirstFrameHits * FramesCount);
+	TestEqual(TEXT("Allocations after the first frame"), Allocations, 0);
+
+	// owner change rebuilds the ignore list
+	AActor* NewOwner = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	Actor->SetOwner(NewOwner);
+	const FCollisionQueryParams& Params = QueryParams.Get(Actor);
+	TestTrue(TEXT("New owner is ignored"), Params.GetIgnoredActors().Contains(NewOwner->GetUniqueID()));
+	TestFalse(TEXT("Previous owner is not ignored"), Params.GetIgnoredActors().Contains(Owner->GetUniqueID()));
+	return true;
+}
+
+#endif
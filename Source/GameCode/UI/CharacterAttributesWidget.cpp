@@ -3,9 +3,11 @@
 
 #include "UI/CharacterAttributesWidget.h"
 #include "Components/ProgressBar.h"
+#include "GameCode.h"
 
 void UCharacterAttributesWidget::SetAttribute(ECharacterAttribute Attribute, float Value)
 {
+	GC_TRACE_SCOPE(UCharacterAttributesWidget_SetAttribute);
 	UProgressBar* Bar = nullptr;
 	switch (Attribute)
 	{
@@ -2,15 +2,18 @@
 #include "WeaponInfoWidget.h"
 #include "ReticleWidget.h"
 #include "Components/TextBlock.h"
+#include "GameCode.h"
 
 void UPlayerHUDWidget::OnAimingStateChanged(bool bAiming, EReticleType ReticleType)
 {
+	GC_TRACE_SCOPE(UPlayerHUDWidget_OnAimingStateChanged);
 	Reticle->OnAimingStateChanged(bAiming);
 	Reticle->SetReticleType(ReticleType);
 }
 
 void UPlayerHUDWidget::SetAmmo(int32 ClipAmmo, int32 RemainingAmmo)
 {
+	GC_TRACE_SCOPE(UPlayerHUDWidget_SetAmmo);
 	if (WeaponInfoWidget->Visibility == ESlateVisibility::Hidden)
 	{
 		WeaponInfoWidget->SetVisibility(ESlateVisibility::HitTestInvisible);
@@ -26,6 +29,7 @@ void UPlayerHUDWidget::SetThrowablesCount(int32 Count)
 
 void UPlayerHUDWidget::OnAttributeChanged(ECharacterAttribute Attribute, float Value)
 {
+	GC_TRACE_SCOPE(UPlayerHUDWidget_OnAttributeChanged);
 	CharacterAttributesWidget->SetAttribute(Attribute, Value);
 }
 
@@ -4,9 +4,11 @@
 #include "UI/WeaponInfoWidget.h"
 
 #include "Components/TextBlock.h"
+#include "GameCode.h"
 
 void UWeaponInfoWidget::SetAmmo(int32 CurrentAmmo, int32 TotalAmmo)
 {
+	GC_TRACE_SCOPE(UWeaponInfoWidget_SetAmmo);
 	ClipAmmoTextblock->SetText(FText::AsNumber(CurrentAmmo));
 	RemainingAmmoTextblock->SetText(FText::AsNumber(TotalAmmo));
 	if (AmmoWidgetsContainerWidget->Visibility == ESlateVisibility::Hidden)
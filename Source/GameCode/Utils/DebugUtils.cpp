@@ -0,0 +1,287 @@
+#include "DebugUtils.h"
+
+#include "DrawDebugHelpers.h"
+#include "Engine/Engine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "GameCode/GameCode.h"
+
+namespace GCDebug
+{
+	const TPair<FName, EGCDebugCategory> CategoryNames[] = {
+		{ FName("LedgeDetection"), EGCDebugCategory::LedgeDetection },
+		{ FName("Wallrun"), EGCDebugCategory::Wallrun },
+		{ FName("Attributes"), EGCDebugCategory::Attributes },
+		{ FName("RangeWeapons"), EGCDebugCategory::RangeWeapons },
+		{ FName("MeleeWeapons"), EGCDebugCategory::MeleeWeapons },
+		{ FName("Movement"), EGCDebugCategory::Movement },
+		{ FName("Equipment"), EGCDebugCategory::Equipment },
+	};
+	
+	EGCDebugCategory FindCategory(const FName& CategoryName)
+	{
+		for (const auto& Entry : CategoryNames)
+		{
+			if (Entry.Key == CategoryName)
+			{
+				return Entry.Value;
+			}
+		}
+	
+		return EGCDebugCategory::None;
+	}
+}
+
+#if ENABLE_DRAW_DEBUG
+
+int32 GCDebug::EnabledCategories = 0;
+
+static FAutoConsoleVariableRef CVarDebugCategories(
+	TEXT("gc.Debug.Categories"),
+	GCDebug::EnabledCategories,
+	TEXT("Bitmask of enabled GameCode debug categories.\n")
+	TEXT("1 - LedgeDetection, 2 - Wallrun, 4 - Attributes, 8 - RangeWeapons, 16 - MeleeWeapons, 32 - Movement, 64 - Equipment"),
+	ECVF_Cheat);
+
+namespace GCDebug
+{
+	enum class EPrimitiveType : uint8
+	{
+		Line,
+		Sphere,
+		Point,
+		Capsule,
+		Box,
+		Message
+	};
+	
+	struct FDebugPrimitive
+	{
+		EPrimitiveType Type = EPrimitiveType::Line;
+		TWeakObjectPtr<const UWorld> World;
+		float Timestamp = 0.f;
+		FVector A = FVector::ZeroVector;
+		// line end, box extent
+		FVector B = FVector::ZeroVector;
+		FQuat Rotation = FQuat::Identity;
+		float Radius = 0.f;
+		float HalfHeight = 0.f;
+		float Thickness = 0.f;
+		float LifeTime = 0.f;
+		FColor Color = FColor::White;
+		int32 MessageKey = INDEX_NONE;
+		FString Message;
+	};
+
+	// Plenty for a few seconds of every category enabled, older entries just get overwritten
+	constexpr int32 BufferCapacity = 4096;
+	TArray<FDebugPrimitive> Buffer;
+	int32 BufferHead = 0;
+	int32 BufferNum = 0;
+	int32 PendingNum = 0;
+
+	FDebugPrimitive& AddPrimitive(EPrimitiveType Type, const UWorld* World, const FColor& Color, float LifeTime)
+	{
+		check(IsInGameThread());
+		GC_LLM_SCOPE(Debug);
+		if (Buffer.Num() == 0)
+		{
+			Buffer.SetNum(BufferCapacity);
+		}
+
+		FDebugPrimitive& Primitive = Buffer[BufferHead];
+		BufferHead = (BufferHead + 1) % BufferCapacity;
+		BufferNum = FMath::Min(BufferNum + 1, BufferCapacity);
+		PendingNum = FMath::Min(PendingNum + 1, BufferCapacity);
+		
+		Primitive.Type = Type;
+		Primitive.World = World;
+		Primitive.Timestamp = IsValid(World) ? World->GetTimeSeconds() : 0.f;
+		Primitive.Color = Color;
+		Primitive.LifeTime = LifeTime;
+		Primitive.Thickness = 0.f;
+		Primitive.Message.Reset();
+		return Primitive;
+	}
+
+	void DrawPrimitive(const FDebugPrimitive& Primitive)
+	{
+		if (Primitive.Type == EPrimitiveType::Message)
+		{
+			if (GEngine)
+			{
+				GEngine->AddOnScreenDebugMessage(Primitive.MessageKey, Primitive.LifeTime, Primitive.Color, Primitive.Message);
+			}
+			
+			return;
+		}
+		
+		const UWorld* World = Primitive.World.Get();
+		if (!IsValid(World))
+		{
+			return;
+		}
+		
+		switch (Primitive.Type)
+		{
+			case EPrimitiveType::Line:
+				DrawDebugLine(World, Primitive.A, Primitive.B, Primitive.Color, false, Primitive.LifeTime, 0, Primitive.Thickness);
+				break;
+			case EPrimitiveType::Sphere:
+				DrawDebugSphere(World, Primitive.A, Primitive.Radius, 16, Primitive.Color, false, Primitive.LifeTime);
+				break;
+			case EPrimitiveType::Point:
+				DrawDebugPoint(World, Primitive.A, Primitive.Radius, Primitive.Color, false, Primitive.LifeTime);
+				break;
+			case EPrimitiveType::Capsule:
+				DrawDebugCapsule(World, Primitive.A, Primitive.HalfHeight, Primitive.Radius, Primitive.Rotation, Primitive.Color,
+					false, Primitive.LifeTime, 0, Primitive.Thickness);
+				break;
+			case EPrimitiveType::Box:
+				DrawDebugBox(World, Primitive.A, Primitive.B, Primitive.Rotation, Primitive.Color, false, Primitive.LifeTime);
+				break;
+			default:
+				break;
+		}
+	}
+
+	FString ToString(const FDebugPrimitive& Primitive)
+	{
+		static const TCHAR* TypeNames[] = { TEXT("Line"), TEXT("Sphere"), TEXT("Point"), TEXT("Capsule"), TEXT("Box"), TEXT("Message") };
+		return Primitive.Type == EPrimitiveType::Message
+			? FString::Printf(TEXT("%.3f\t%s\t%s"), Primitive.Timestamp, TypeNames[(uint8)Primitive.Type], *Primitive.Message)
+			: FString::Printf(TEXT("%.3f\t%s\t%s\t%s\tR=%.1f\tHH=%.1f\t%s"), Primitive.Timestamp, TypeNames[(uint8)Primitive.Type],
+				*Primitive.A.ToString(), *Primitive.B.ToString(), Primitive.Radius, Primitive.HalfHeight, *Primitive.Color.ToString());
+	}
+
+	template<typename TFunc>
+	void ForEachPrimitive(int32 Count, TFunc Func)
+	{
+		const int32 Start = (BufferHead - Count + BufferCapacity) % BufferCapacity;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Func(Buffer[(Start + i) % BufferCapacity]);
+		}
+	}
+}
+
+void GCDebug::SetCategoryEnabled(EGCDebugCategory Category, bool bEnabled)
+{
+	EnabledCategories = bEnabled ? EnabledCategories | (int32)Category : EnabledCategories & ~(int32)Category;
+}
+
+void GCDebug::DrawLine(const UWorld* World, const FVector& Start, const FVector& End, const FColor& Color, float LifeTime, float Thickness)
+{
+	FDebugPrimitive& Primitive = AddPrimitive(EPrimitiveType::Line, World, Color, LifeTime);
+	Primitive.A = Start;
+	Primitive.B = End;
+	Primitive.Thickness = Thickness;
+}
+
+void GCDebug::DrawSphere(const UWorld* World, const FVector& Center, float Radius, const FColor& Color, float LifeTime)
+{
+	FDebugPrimitive& Primitive = AddPrimitive(EPrimitiveType::Sphere, World, Color, LifeTime);
+	Primitive.A = Center;
+	Primitive.Radius = Radius;
+}
+
+void GCDebug::DrawPoint(const UWorld* World, const FVector& Location, float Size, const FColor& Color, float LifeTime)
+{
+	FDebugPrimitive& Primitive = AddPrimitive(EPrimitiveType::Point, World, Color, LifeTime);
+	Primitive.A = Location;
+	Primitive.Radius = Size;
+}
+
+void GCDebug::DrawCapsule(const UWorld* World, const FVector& Center, float HalfHeight, float Radius, const FQuat& Rotation,
+	const FColor& Color, float LifeTime, float Thickness)
+{
+	FDebugPrimitive& Primitive = AddPrimitive(EPrimitiveType::Capsule, World, Color, LifeTime);
+	Primitive.A = Center;
+	Primitive.HalfHeight = HalfHeight;
+	Primitive.Radius = Radius;
+	Primitive.Rotation = Rotation;
+	Primitive.Thickness = Thickness;
+}
+
+void GCDebug::DrawBox(const UWorld* World, const FVector& Center, const FVector& Extent, const FQuat& Rotation,
+	const FColor& Color, float LifeTime)
+{
+	FDebugPrimitive& Primitive = AddPrimitive(EPrimitiveType::Box, World, Color, LifeTime);
+	Primitive.A = Center;
+	Primitive.B = Extent;
+	Primitive.Rotation = Rotation;
+}
+
+void GCDebug::DrawTrace(const UWorld* World, const FVector& Start, const FVector& End, bool bHit, const FVector& HitLocation,
+	const FColor& TraceColor, const FColor& HitColor, float LifeTime)
+{
+	DrawLine(World, Start, bHit ? HitLocation : End, TraceColor, LifeTime);
+	if (bHit)
+	{
+		DrawLine(World, HitLocation, End, HitColor, LifeTime);
+		DrawPoint(World, HitLocation, 10.f, HitColor, LifeTime);
+	}
+}
+
+void GCDebug::AddMessage(int32 Key, float LifeTime, const FColor& Color, const FString& Message)
+{
+	GC_LLM_SCOPE(Debug);
+	FDebugPrimitive& Primitive = AddPrimitive(EPrimitiveType::Message, nullptr, Color, LifeTime);
+	Primitive.MessageKey = Key;
+	Primitive.Message = Message;
+}
+
+bool GCDebug::HasPendingPrimitives()
+{
+	return PendingNum > 0;
+}
+
+void GCDebug::Flush()
+{
+	if (PendingNum == 0)
+	{
+		return;
+	}
+	
+	GC_LLM_SCOPE(Debug);
+	if (FApp::CanEverRender())
+	{
+		ForEachPrimitive(PendingNum, DrawPrimitive);
+	}
+	else
+	{
+		FString Dump;
+		ForEachPrimitive(PendingNum, [&Dump](const FDebugPrimitive& Primitive) { Dump += ToString(Primitive) + LINE_TERMINATOR; });
+		FFileHelper::SaveStringToFile(Dump, *FPaths::Combine(FPaths::ProjectLogDir(), DumpFileName),
+			FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+	}
+	
+	PendingNum = 0;
+}
+
+void GCDebug::DumpToFile(const FString& FilePath)
+{
+	GC_LLM_SCOPE(Debug);
+	FString Dump;
+	ForEachPrimitive(BufferNum, [&Dump](const FDebugPrimitive& Primitive) { Dump += ToString(Primitive) + LINE_TERMINATOR; });
+	FFileHelper::SaveStringToFile(Dump, *FilePath);
+}
+
+#else
+
+void GCDebug::SetCategoryEnabled(EGCDebugCategory Category, bool bEnabled) {}
+void GCDebug::DrawLine(const UWorld* World, const FVector& Start, const FVector& End, const FColor& Color, float LifeTime, float Thickness) {}
+void GCDebug::DrawSphere(const UWorld* World, const FVector& Center, float Radius, const FColor& Color, float LifeTime) {}
+void GCDebug::DrawPoint(const UWorld* World, const FVector& Location, float Size, const FColor& Color, float LifeTime) {}
+void GCDebug::DrawCapsule(const UWorld* World, const FVector& Center, float HalfHeight, float Radius, const FQuat& Rotation,
+	const FColor& Color, float LifeTime, float Thickness) {}
+void GCDebug::DrawBox(const UWorld* World, const FVector& Center, const FVector& Extent, const FQuat& Rotation,
+	const FColor& Color, float LifeTime) {}
+void GCDebug::DrawTrace(const UWorld* World, const FVector& Start, const FVector& End, bool bHit, const FVector& HitLocation,
+	const FColor& TraceColor, const FColor& HitColor, float LifeTime) {}
+void GCDebug::AddMessage(int32 Key, float LifeTime, const FColor& Color, const FString& Message) {}
+bool GCDebug::HasPendingPrimitives() { return false; }
+void GCDebug::Flush() {}
+void GCDebug::DumpToFile(const FString& FilePath) {}
+
+#endif
@@ -1,20 +1,52 @@
-﻿#pragma once
+#pragma once
 
-#include "GCDebugSubsystem.h"
-#include "Kismet/GameplayStatics.h"
+#include "CoreMinimal.h"
 
-#if UE_BUILD_DEVELOPMENT || UE_BUILD_DEBUG
-
-static TWeakObjectPtr<UGCDebugSubsystem> DebugSubsystem = nullptr;
+enum class EGCDebugCategory : uint32
+{
+	None = 0,
+	LedgeDetection = 1 << 0,
+	Wallrun = 1 << 1,
+	Attributes = 1 << 2,
+	RangeWeapons = 1 << 3,
+	MeleeWeapons = 1 << 4,
+	Movement = 1 << 5,
+	Equipment = 1 << 6,
+};
+ENUM_CLASS_FLAGS(EGCDebugCategory)
 
-const UGCDebugSubsystem* GetDebugSubsystem(UWorld* World)
+namespace GCDebug
 {
-	if (!DebugSubsystem.Get())
-	{
-		DebugSubsystem = UGameplayStatics::GetGameInstance(World)->GetSubsystem<UGCDebugSubsystem>();
-	}
+#if ENABLE_DRAW_DEBUG
+	// EGCDebugCategory bitmask, driven by gc.Debug.Categories
+	extern int32 EnabledCategories;
 
-	return DebugSubsystem.Get();
-}
+	FORCEINLINE bool IsCategoryEnabled(EGCDebugCategory Category) { return (EnabledCategories & (int32)Category) != 0; }
+#else
+	constexpr bool IsCategoryEnabled(EGCDebugCategory Category) { return false; }
+#endif
 
-#endif	
+	EGCDebugCategory FindCategory(const FName& CategoryName);
+	void SetCategoryEnabled(EGCDebugCategory Category, bool bEnabled);
+	
+	// Recording only copies the primitive into a fixed size ring buffer. UGCDebugSubsystem flushes it once per frame:
+	// to screen when there's a viewport to render to, appended to DumpFileName otherwise (dedicated servers, -nullrhi runs).
+	// Callers are expected to check IsCategoryEnabled first, everything here compiles to nothing without ENABLE_DRAW_DEBUG
+	void DrawLine(const UWorld* World, const FVector& Start, const FVector& End, const FColor& Color, float LifeTime = 2.f, float Thickness = 0.f);
+	void DrawSphere(const UWorld* World, const FVector& Center, float Radius, const FColor& Color, float LifeTime = 2.f);
+	void DrawPoint(const UWorld* World, const FVector& Location, float Size, const FColor& Color, float LifeTime = 2.f);
+	void DrawCapsule(const UWorld* World, const FVector& Center, float HalfHeight, float Radius, const FQuat& Rotation,
+		const FColor& Color, float LifeTime = 2.f, float Thickness = 0.f);
+	void DrawBox(const UWorld* World, const FVector& Center, const FVector& Extent, const FQuat& Rotation, const FColor& Color, float LifeTime = 2.f);
+	void DrawTrace(const UWorld* World, const FVector& Start, const FVector& End, bool bHit, const FVector& HitLocation,
+		const FColor& TraceColor = FColor::Red, const FColor& HitColor = FColor::Green, float LifeTime = 2.f);
+
+	// Replacement for GEngine->AddOnScreenDebugMessage. Key works the same way: -1 always adds a new line
+	void AddMessage(int32 Key, float LifeTime, const FColor& Color, const FString& Message);
+	
+	bool HasPendingPrimitives();
+	void Flush();
+	void DumpToFile(const FString& FilePath);
+
+	const TCHAR* const DumpFileName = TEXT("GCDebugPrimitives.log");
+}
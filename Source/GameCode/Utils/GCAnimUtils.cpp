@@ -0,0 +1,82 @@
+#include "GCAnimUtils.h"
+
+#include "BonePose.h"
+#include "Animation/AnimationPoseData.h"
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/CustomAttributesRuntime.h"
+#include "Components/SkeletalMeshComponent.h"
+
+bool GCAnimUtils::FMontageBoneSampler::Initialize(const USkeletalMeshComponent* Mesh, FName BoneName)
+{
+	CachedMesh = Mesh;
+	CachedBoneName = BoneName;
+	CompactBoneIndex = FCompactPoseBoneIndex(INDEX_NONE);
+	if (!IsValid(Mesh) || !IsValid(Mesh->SkeletalMesh))
+	{
+		return false;
+	}
+
+	const FReferenceSkeleton& RefSkeleton = Mesh->SkeletalMesh->GetRefSkeleton();
+	int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName);
+	if (BoneIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	TArray<FBoneIndexType> RequiredBones;
+	for (; BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+	{
+		RequiredBones.Insert(BoneIndex, 0);
+	}
+
+	BoneContainer.InitializeTo(RequiredBones, FCurveEvaluationOption(false), *Mesh->SkeletalMesh);
+	CompactBoneIndex = BoneContainer.MakeCompactPoseIndex(FMeshPoseBoneIndex(RequiredBones.Last()));
+	return CompactBoneIndex != INDEX_NONE;
+}
+
+bool GCAnimUtils::FMontageBoneSampler::IsInitializedFor(const USkeletalMeshComponent* Mesh, FName BoneName) const
+{
+	return CachedMesh.Get() == Mesh && CachedBoneName == BoneName && CompactBoneIndex != INDEX_NONE;
+}
+
+bool GCAnimUtils::FMontageBoneSampler::Sample(const UAnimMontage* Montage, float Position, FTransform& OutComponentTransform) const
+{
+	if (CompactBoneIndex == INDEX_NONE || !IsValid(Montage) || Montage->SlotAnimTracks.Num() == 0)
+	{
+		return false;
+	}
+
+	// montages of this project have a single slot
+	const FAnimSegment* Segment = Montage->SlotAnimTracks[0].AnimTrack.GetSegmentAtTime(Position);
+	float PositionInAnim = 0.f;
+	const UAnimSequence* Sequence = Segment != nullptr ? Cast<UAnimSequence>(Segment->GetAnimationData(Position, PositionInAnim)) : nullptr;
+	if (!IsValid(Sequence))
+	{
+		return false;
+	}
+
+	FMemMark Mark(FMemStack::Get());
+	FCompactPose Pose;
+	Pose.SetBoneContainer(&BoneContainer);
+	FBlendedCurve Curve;
+	Curve.InitFrom(BoneContainer);
+	FStackCustomAttributes Attributes;
+	FAnimationPoseData PoseData(Pose, Curve, Attributes);
+	Sequence->GetBonePose(PoseData, FAnimExtractContext(PositionInAnim));
+
+	// root motion is applied to the character, not to the pose
+	if (Montage->HasRootMotion())
+	{
+		Pose[FCompactPoseBoneIndex(0)] = BoneContainer.GetRefPoseTransform(FCompactPoseBoneIndex(0));
+	}
+
+	OutComponentTransform = Pose[CompactBoneIndex];
+	for (FCompactPoseBoneIndex ParentIndex = BoneContainer.GetParentBoneIndex(CompactBoneIndex); ParentIndex != INDEX_NONE;
+		ParentIndex = BoneContainer.GetParentBoneIndex(ParentIndex))
+	{
+		OutComponentTransform *= Pose[ParentIndex];
+	}
+
+	return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoneContainer.h"
+
+class UAnimMontage;
+class USkeletalMeshComponent;
+
+namespace GCAnimUtils
+{
+	// Component space transform of a single bone sampled straight from montage animation data at any montage position,
+	// without ticking the anim instance. Only the montage is evaluated: no blending, layering or IK
+	struct FMontageBoneSampler
+	{
+		bool Initialize(const USkeletalMeshComponent* Mesh, FName BoneName);
+		bool IsInitializedFor(const USkeletalMeshComponent* Mesh, FName BoneName) const;
+		bool Sample(const UAnimMontage* Montage, float Position, FTransform& OutComponentTransform) const;
+
+	private:
+		// the bone and all its parents
+		FBoneContainer BoneContainer;
+		FCompactPoseBoneIndex CompactBoneIndex = FCompactPoseBoneIndex(INDEX_NONE);
+		TWeakObjectPtr<const USkeletalMeshComponent> CachedMesh;
+		FName CachedBoneName = NAME_None;
+	};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Fixed fire rate accumulator. Every shot due during a frame is returned at once together with how long ago it was due,
+// so fire rates above the frame rate aren't quantized to one shot per frame and the leftover time carries to the next frame
+struct FFireScheduler
+{
+	void Start(float InInterval, float FirstShotDelay)
+	{
+		Interval = FMath::Max(InInterval, KINDA_SMALL_NUMBER);
+		TimeToNextShot = FirstShotDelay;
+	}
+
+	// Returns amount of shots due after DeltaTime, but no more than MaxShots. OutShotAges[i] - how long ago i-th shot was due,
+	// oldest first
+	template<typename AllocatorType>
+	int32 Advance(float DeltaTime, TArray<float, AllocatorType>& OutShotAges, int32 MaxShots)
+	{
+		OutShotAges.Reset();
+		TimeToNextShot -= DeltaTime;
+		while (TimeToNextShot <= 0.f && OutShotAges.Num() < MaxShots)
+		{
+			OutShotAges.Add(-TimeToNextShot);
+			TimeToNextShot += Interval;
+		}
+
+		// shots over the limit are dropped instead of piling up
+		TimeToNextShot = FMath::Max(TimeToNextShot, 0.f);
+		return OutShotAges.Num();
+	}
+
+	// Not firing: runs the cooldown of the last shot out without banking shots
+	void Cooldown(float DeltaTime) { TimeToNextShot = FMath::Max(TimeToNextShot - DeltaTime, 0.f); }
+	bool IsReady() const { return TimeToNextShot <= 0.f; }
+	void Reset() { TimeToNextShot = 0.f; }
+
+private:
+	float Interval = 0.1f;
+	float TimeToNextShot = 0.f;
+};
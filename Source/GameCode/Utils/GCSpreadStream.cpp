@@ -0,0 +1,102 @@
+#include "GCSpreadStream.h"
+
+namespace
+{
+	constexpr int32 RotationTableSize = 256;
+
+	// cos and sin of the roll angle around the shot direction
+	struct FRotationTable
+	{
+		FRotationTable()
+		{
+			for (int32 i = 0; i < RotationTableSize; ++i)
+			{
+				FMath::SinCos(&Sin[i], &Cos[i], 2.f * PI * i / RotationTableSize);
+			}
+		}
+
+		float Sin[RotationTableSize];
+		float Cos[RotationTableSize];
+	};
+
+	const FRotationTable& GetRotationTable()
+	{
+		static const FRotationTable RotationTable;
+		return RotationTable;
+	}
+}
+
+void FSpreadStream::Initialize(int32 InSeed)
+{
+	Stream.Initialize(InSeed);
+}
+
+void FSpreadStream::GenerateDirections(const FRotator& Orientation, float SpreadAngleRad, FVector* OutDirections, int32 Count)
+{
+	UpdateSpreadTable(SpreadAngleRad);
+	const FRotationTable& RotationTable = GetRotationTable();
+	const FRotationMatrix OrientationMatrix(Orientation);
+	const FVector Forward = OrientationMatrix.GetScaledAxis(EAxis::X);
+	const FVector Right = OrientationMatrix.GetScaledAxis(EAxis::Y);
+	const FVector Up = OrientationMatrix.GetScaledAxis(EAxis::Z);
+	const VectorRegister ForwardX = VectorSetFloat1(Forward.X);
+	const VectorRegister ForwardY = VectorSetFloat1(Forward.Y);
+	const VectorRegister ForwardZ = VectorSetFloat1(Forward.Z);
+	const VectorRegister RightX = VectorSetFloat1(Right.X);
+	const VectorRegister RightY = VectorSetFloat1(Right.Y);
+	const VectorRegister RightZ = VectorSetFloat1(Right.Z);
+	const VectorRegister UpX = VectorSetFloat1(Up.X);
+	const VectorRegister UpY = VectorSetFloat1(Up.Y);
+	const VectorRegister UpZ = VectorSetFloat1(Up.Z);
+
+	// 4 pellets per iteration. Random numbers are always drawn in the same order, so the pattern only depends on the seed
+	MS_ALIGN(16) float Sizes[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float Sins[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float Coss[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float Directions[3][4] GCC_ALIGN(16);
+	for (int32 Base = 0; Base < Count; Base += 4)
+	{
+		const int32 BatchCount = FMath::Min(Count - Base, 4);
+		for (int32 i = 0; i < 4; ++i)
+		{
+			if (i >= BatchCount)
+			{
+				Sizes[i] = Sins[i] = Coss[i] = 0.f;
+				continue;
+			}
+			
+			const float TablePosition = Stream.GetFraction() * SpreadTableSize;
+			const int32 TableIndex = FMath::Min((int32)TablePosition, SpreadTableSize - 1);
+			Sizes[i] = FMath::Lerp(SpreadTable[TableIndex], SpreadTable[TableIndex + 1], TablePosition - TableIndex);
+			const int32 RotationIndex = Stream.RandHelper(RotationTableSize);
+			Sins[i] = RotationTable.Sin[RotationIndex];
+			Coss[i] = RotationTable.Cos[RotationIndex];
+		}
+
+		// direction = forward + (up * sin + right * cos) * tan(pitch)
+		const VectorRegister Size = VectorLoadAligned(Sizes);
+		const VectorRegister UpScale = VectorMultiply(VectorLoadAligned(Sins), Size);
+		const VectorRegister RightScale = VectorMultiply(VectorLoadAligned(Coss), Size);
+		VectorStoreAligned(VectorMultiplyAdd(UpX, UpScale, VectorMultiplyAdd(RightX, RightScale, ForwardX)), Directions[0]);
+		VectorStoreAligned(VectorMultiplyAdd(UpY, UpScale, VectorMultiplyAdd(RightY, RightScale, ForwardY)), Directions[1]);
+		VectorStoreAligned(VectorMultiplyAdd(UpZ, UpScale, VectorMultiplyAdd(RightZ, RightScale, ForwardZ)), Directions[2]);
+		for (int32 i = 0; i < BatchCount; ++i)
+		{
+			OutDirections[Base + i] = FVector(Directions[0][i], Directions[1][i], Directions[2][i]);
+		}
+	}
+}
+
+void FSpreadStream::UpdateSpreadTable(float SpreadAngleRad)
+{
+	if (SpreadAngleRad == SpreadTableAngle)
+	{
+		return;
+	}
+
+	SpreadTableAngle = SpreadAngleRad;
+	for (int32 i = 0; i <= SpreadTableSize; ++i)
+	{
+		SpreadTable[i] = FMath::Tan(SpreadAngleRad * i / SpreadTableSize);
+	}
+}
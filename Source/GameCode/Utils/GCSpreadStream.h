@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Seeded bullet spread. Same seed and same sequence of shots give the same pellet directions, so spread patterns
+// can be reproduced. Directions are generated 4 pellets at a time from precomputed cone tables instead of
+// tan/sin/cos per pellet
+struct FSpreadStream
+{
+	void Initialize(int32 InSeed);
+	// back to the first shot of the seed
+	void Reset() { Stream.Reset(); }
+	int32 GetSeed() const { return Stream.GetInitialSeed(); }
+	// Initialize with it to continue the sequence from the next shot
+	int32 GetCurrentSeed() const { return Stream.GetCurrentSeed(); }
+
+	// Uniform spread angle up to SpreadAngleRad around Orientation. Directions aren't normalized
+	template<typename AllocatorType>
+	void GenerateDirections(const FRotator& Orientation, float SpreadAngleRad, int32 Count, TArray<FVector, AllocatorType>& OutDirections)
+	{
+		OutDirections.SetNumUninitialized(Count);
+		GenerateDirections(Orientation, SpreadAngleRad, OutDirections.GetData(), Count);
+	}
+
+	void GenerateDirections(const FRotator& Orientation, float SpreadAngleRad, FVector* OutDirections, int32 Count);
+
+private:
+	void UpdateSpreadTable(float SpreadAngleRad);
+	
+	FRandomStream Stream;
+	
+	static constexpr int32 SpreadTableSize = 32;
+	// tan of the pitch angle from 0 to the spread angle
+	float SpreadTable[SpreadTableSize + 1];
+	float SpreadTableAngle = -1.f;
+};
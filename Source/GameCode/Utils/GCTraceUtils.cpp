@@ -1,6 +1,96 @@
 ﻿#include "GCTraceUtils.h"
 
-#include "DrawDebugHelpers.h"
+#include "DebugUtils.h"
+#include "GameCode/GameCode.h"
+
+GCTraceUtils::FOwnerChainQueryParams::FOwnerChainQueryParams(FName TraceTag, bool bTraceComplex, bool bReturnPhysicalMaterial)
+	: Params(TraceTag, bTraceComplex)
+{
+	Params.bReturnPhysicalMaterial = bReturnPhysicalMaterial;
+}
+
+const FCollisionQueryParams& GCTraceUtils::FOwnerChainQueryParams::Get(const AActor* Actor)
+{
+	if (!IsOwnerChainCached(Actor))
+	{
+		Rebuild(Actor);
+	}
+	
+	return Params;
+}
+
+void GCTraceUtils::FOwnerChainQueryParams::Invalidate()
+{
+	Params.ClearIgnoredActors();
+	CachedOwnerChain.Reset();
+}
+
+bool GCTraceUtils::FOwnerChainQueryParams::IsOwnerChainCached(const AActor* Actor) const
+{
+	int32 Index = 0;
+	for (const AActor* Current = Actor; IsValid(Current); Current = Current->GetOwner(), ++Index)
+	{
+		if (!CachedOwnerChain.IsValidIndex(Index) || CachedOwnerChain[Index].Get() != Current)
+		{
+			return false;
+		}
+	}
+
+	return Index == CachedOwnerChain.Num();
+}
+
+void GCTraceUtils::FOwnerChainQueryParams::Rebuild(const AActor* Actor)
+{
+	Invalidate();
+	for (const AActor* Current = Actor; IsValid(Current); Current = Current->GetOwner())
+	{
+		Params.AddIgnoredActor(Current);
+		CachedOwnerChain.Add(Current);
+	}
+}
+
+bool GCTraceUtils::LineTraceSingleByChannel(const UWorld* const World, FHitResult& OutHit, const FVector& Start,
+	const FVector& End, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
+	const FTraceParams& TraceParams, const FCollisionResponseParams& ResponseParam)
+{
+	GC_COUNT_TRACES(1);
+	const bool bHit = World->LineTraceSingleByChannel(OutHit, Start, End, TraceChannel, Params, ResponseParam);
+
+#if ENABLE_DRAW_DEBUG
+	if (TraceParams.bDrawDebug)
+	{
+		GCDebug::DrawTrace(World, Start, End, bHit, OutHit.ImpactPoint, TraceParams.TraceColor, TraceParams.HitColor,
+			TraceParams.DrawTime);
+	}
+#endif
+
+	return bHit;
+}
+
+bool GCTraceUtils::SweepBoxSingleByChannel(const UWorld* const World, FHitResult& OutHit, const FVector& Start,
+	const FVector& End, const FVector& HalfSize, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
+	const FTraceParams& TraceParams, const FQuat& Rot, const FCollisionResponseParams& ResponseParam)
+{
+	const FCollisionShape BoxShape = FCollisionShape::MakeBox(HalfSize);
+	GC_COUNT_TRACES(1);
+	const bool bHit = World->SweepSingleByChannel(OutHit, Start, End, Rot, TraceChannel, BoxShape, Params, ResponseParam);
+
+#if ENABLE_DRAW_DEBUG
+	if (TraceParams.bDrawDebug)
+	{
+		GCDebug::DrawBox(World, Start, HalfSize, Rot, TraceParams.TraceColor, TraceParams.DrawTime);
+		GCDebug::DrawBox(World, End, HalfSize, Rot, TraceParams.TraceColor, TraceParams.DrawTime);
+		GCDebug::DrawLine(World, Start, End, FColor::Yellow, TraceParams.DrawTime);
+		if (bHit)
+		{
+			GCDebug::DrawBox(World, OutHit.Location, HalfSize, Rot, TraceParams.HitColor, TraceParams.DrawTime);
+			GCDebug::DrawPoint(World, OutHit.ImpactPoint, 10.f, TraceParams.HitColor, TraceParams.DrawTime);
+		}
+	}
+#endif
+
+	return bHit;
+}
 
 bool GCTraceUtils::SweepCapsuleSingleByChannel(const UWorld* const World, FHitResult& OutHit, const FVector& Start,
                                                const FVector& End, float CapsuleRadius, float CapsuleHalfHeight, ECollisionChannel TraceChannel,
@@ -8,22 +98,22 @@ bool GCTraceUtils::SweepCapsuleSingleByChannel(const UWorld* const World, FHitRe
                                                const FCollisionResponseParams& ResponseParam)
 {
 	const FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
+	GC_COUNT_TRACES(1);
 	const bool bHit = World->SweepSingleByChannel(OutHit, Start, End, Rot, TraceChannel, CapsuleShape, Params, ResponseParam);
 
 #if ENABLE_DRAW_DEBUG
 	if (TraceParams.bDrawDebug)
 	{
-		DrawDebugCapsule(World, Start, CapsuleHalfHeight, CapsuleRadius,FQuat::Identity, TraceParams.TraceColor,
-			false, TraceParams.DrawTime);
-		DrawDebugCapsule(World, End, CapsuleHalfHeight, CapsuleRadius,FQuat::Identity, TraceParams.TraceColor,
-			false, TraceParams.DrawTime);
-		DrawDebugLine(World, Start, End, FColor::Yellow, false,	TraceParams.DrawTime, 0, 2);
+		GCDebug::DrawCapsule(World, Start, CapsuleHalfHeight, CapsuleRadius, FQuat::Identity, TraceParams.TraceColor,
+			TraceParams.DrawTime);
+		GCDebug::DrawCapsule(World, End, CapsuleHalfHeight, CapsuleRadius, FQuat::Identity, TraceParams.TraceColor,
+			TraceParams.DrawTime);
+		GCDebug::DrawLine(World, Start, End, FColor::Yellow, TraceParams.DrawTime, 2);
 		if (bHit)
 		{
-			DrawDebugCapsule(World, OutHit.Location, CapsuleHalfHeight, CapsuleRadius,
-		FQuat::Identity, TraceParams.HitColor, false, TraceParams.DrawTime);
-			DrawDebugPoint(World, OutHit.ImpactPoint, 10.f, TraceParams.HitColor, false,
-				TraceParams.DrawTime);	
+			GCDebug::DrawCapsule(World, OutHit.Location, CapsuleHalfHeight, CapsuleRadius,
+				FQuat::Identity, TraceParams.HitColor, TraceParams.DrawTime);
+			GCDebug::DrawPoint(World, OutHit.ImpactPoint, 10.f, TraceParams.HitColor, TraceParams.DrawTime);	
 		}
 	}
 #endif
@@ -37,6 +127,7 @@ bool GCTraceUtils::SweepSphereSingleByChannel(const UWorld* const World, FHitRes
 	const FCollisionResponseParams& ResponseParam)
 {
 	const FCollisionShape SphereShape = FCollisionShape::MakeSphere(Radius);
+	GC_COUNT_TRACES(1);
 	const bool bHit = World->SweepSingleByChannel(OutHit, Start, End, Rot, TraceChannel, SphereShape, Params, ResponseParam);
 
 #if ENABLE_DRAW_DEBUG
@@ -47,17 +138,17 @@ bool GCTraceUtils::SweepSphereSingleByChannel(const UWorld* const World, FHitRes
 		const FQuat Quat = FRotationMatrix::MakeFromZ(TraceVector).ToQuat();
 		// const FQuat Quat = TraceVector.ToOrientationQuat(); // same???
 	
-		DrawDebugSphere(World, Start, Radius, 16, TraceParams.TraceColor,false, TraceParams.DrawTime);
-		DrawDebugSphere(World, End, Radius, 16, TraceParams.TraceColor,false, TraceParams.DrawTime);
-		DrawDebugLine(World, Start, End, FColor::Yellow, false,	TraceParams.DrawTime, 0, 2);
+		GCDebug::DrawSphere(World, Start, Radius, TraceParams.TraceColor, TraceParams.DrawTime);
+		GCDebug::DrawSphere(World, End, Radius, TraceParams.TraceColor, TraceParams.DrawTime);
+		GCDebug::DrawLine(World, Start, End, FColor::Yellow, TraceParams.DrawTime, 2);
 
-		DrawDebugCapsule(World, (Start + End) * 0.5, HalfHeight, Radius, Quat,
-			FColor::Yellow,false, TraceParams.DrawTime);
+		GCDebug::DrawCapsule(World, (Start + End) * 0.5, HalfHeight, Radius, Quat,
+			FColor::Yellow, TraceParams.DrawTime);
 		
 		if (bHit)
 		{
-			DrawDebugSphere(World, OutHit.Location, Radius, 16, TraceParams.HitColor,false, TraceParams.DrawTime);
-			DrawDebugPoint(World, OutHit.ImpactPoint, 10.f, FColor::Green, false, TraceParams.DrawTime);
+			GCDebug::DrawSphere(World, OutHit.Location, Radius, TraceParams.HitColor, TraceParams.DrawTime);
+			GCDebug::DrawPoint(World, OutHit.ImpactPoint, 10.f, FColor::Green, TraceParams.DrawTime);
 		}
 	}
 #endif
@@ -65,17 +156,42 @@ bool GCTraceUtils::SweepSphereSingleByChannel(const UWorld* const World, FHitRes
 	return bHit;
 }
 
+bool GCTraceUtils::SweepSphereMultiByChannel(const UWorld* const World, TArray<FHitResult>& OutHits, const FVector& Start,
+	const FVector& End, float Radius, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
+	const FTraceParams& TraceParams, const FCollisionResponseParams& ResponseParam)
+{
+	const FCollisionShape SphereShape = FCollisionShape::MakeSphere(Radius);
+	GC_COUNT_TRACES(1);
+	World->SweepMultiByChannel(OutHits, Start, End, FQuat::Identity, TraceChannel, SphereShape, Params, ResponseParam);
+	const bool bHit = OutHits.Num() > 0;
+
+#if ENABLE_DRAW_DEBUG
+	if (TraceParams.bDrawDebug)
+	{
+		GCDebug::DrawSphere(World, Start, Radius, TraceParams.TraceColor, TraceParams.DrawTime);
+		GCDebug::DrawLine(World, Start, End, FColor::Yellow, TraceParams.DrawTime, 2);
+		for (const FHitResult& Hit : OutHits)
+		{
+			GCDebug::DrawSphere(World, Hit.Location, Radius, TraceParams.HitColor, TraceParams.DrawTime);
+			GCDebug::DrawPoint(World, Hit.ImpactPoint, 10.f, TraceParams.HitColor, TraceParams.DrawTime);
+		}
+	}
+#endif
+
+	return bHit;
+}
+
 bool GCTraceUtils::OverlapCapsuleAnyByProfile(const UWorld* World, const FVector& Location, float Radius, float HalfHeight,
 	FName Profile, const FCollisionQueryParams& QueryParams, const FTraceParams& TraceParams, const FQuat& Quat)
 {
 	FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+	GC_COUNT_TRACES(1);
 	bool bOverlap = World->OverlapAnyTestByProfile(Location, Quat, Profile, CollisionShape, QueryParams);
 
 #if ENABLE_DRAW_DEBUG
 	if (bOverlap && TraceParams.bDrawDebug)
 	{
-		DrawDebugCapsule(World, Location, HalfHeight, Radius, Quat, FColor::Cyan, false,
-			TraceParams.DrawTime, 0, 3);
+		GCDebug::DrawCapsule(World, Location, HalfHeight, Radius, Quat, FColor::Cyan, TraceParams.DrawTime, 3);
 	}
 #endif
 	
@@ -86,13 +202,13 @@ bool GCTraceUtils::OverlapCapsuleBlockingByProfile(const UWorld* World, const FV
 	FName Profile, const FCollisionQueryParams& QueryParams, const FTraceParams& TraceParams, const FQuat& Quat)
 {
 	FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+	GC_COUNT_TRACES(1);
 	bool bOverlap = World->OverlapBlockingTestByProfile(Location, Quat, Profile, CollisionShape, QueryParams);
 
 #if ENABLE_DRAW_DEBUG
 	if (bOverlap && TraceParams.bDrawDebug)
 	{
-		DrawDebugCapsule(World, Location, HalfHeight, Radius, Quat, FColor::Cyan, false,
-			TraceParams.DrawTime, 0, 3);
+		GCDebug::DrawCapsule(World, Location, HalfHeight, Radius, Quat, FColor::Cyan, TraceParams.DrawTime, 3);
 	}
 #endif
 	
@@ -1,5 +1,8 @@
 ﻿#pragma once
 
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+
 namespace GCTraceUtils
 {
 	struct FTraceParams
@@ -18,6 +21,35 @@ namespace GCTraceUtils
 		FColor TraceColor = FColor::Red;
 		FColor HitColor = FColor::Green;
 	};
+
+	// Query params ignoring the whole owner chain of an actor. Rebuilt only when the chain changes,
+	// so hot paths don't reconstruct params (or go through kismet wrappers) every query
+	struct FOwnerChainQueryParams
+	{
+		FOwnerChainQueryParams(FName TraceTag = NAME_None, bool bTraceComplex = false, bool bReturnPhysicalMaterial = false);
+
+		const FCollisionQueryParams& Get(const AActor* Actor);
+		void Invalidate();
+		
+	private:
+		bool IsOwnerChainCached(const AActor* Actor) const;
+		void Rebuild(const AActor* Actor);
+		
+		FCollisionQueryParams Params;
+		TArray<TWeakObjectPtr<const AActor>, TInlineAllocator<4>> CachedOwnerChain;
+	};
+
+	bool LineTraceSingleByChannel(const class UWorld* const World, struct FHitResult& OutHit,
+		const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+		const FCollisionQueryParams& Params,
+		const FTraceParams& TraceParams,
+		const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam);
+
+	bool SweepBoxSingleByChannel(const class UWorld* const World, struct FHitResult& OutHit,
+		const FVector& Start, const FVector& End, const FVector& HalfSize, ECollisionChannel TraceChannel,
+		const FCollisionQueryParams& Params,
+		const FTraceParams& TraceParams, const FQuat& Rot = FQuat::Identity,
+		const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam);
 	
 	bool SweepCapsuleSingleByChannel(const class UWorld* const World, struct FHitResult& OutHit,
 		const FVector& Start, const FVector& End, float CapsuleRadius, float CapsuleHalfHeight,
@@ -33,6 +65,12 @@ namespace GCTraceUtils
 		const FTraceParams& TraceParams, const FQuat& Rot = FQuat::Identity,
 		const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam);
 
+	bool SweepSphereMultiByChannel(const class UWorld* const World, TArray<struct FHitResult>& OutHits,
+		const FVector& Start, const FVector& End, float Radius, ECollisionChannel TraceChannel,
+		const FCollisionQueryParams& Params,
+		const FTraceParams& TraceParams,
+		const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam);
+
 	bool OverlapCapsuleAnyByProfile(const class UWorld* World, const FVector& Location,
 		float Radius, float HalfHeight, FName Profile, 
 		const FCollisionQueryParams& QueryParams, const FTraceParams& TraceParams,